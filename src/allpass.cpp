@@ -32,8 +32,9 @@
 
  void AllPass::setBuffer( float *buf, int size )
  {
-     _buffer  = buf;
-     _bufSize = size;
+     _buffer   = buf;
+     _bufSize  = size;
+     _bufIndex = 0;
  }
 
  void AllPass::mute()
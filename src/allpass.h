@@ -48,6 +48,23 @@ class AllPass
             }
             return output;
         }
+
+        // a true (unity gain) allpass, unlike the Freeverb approximation in process()
+        // which colors the signal, suited for diffusing a signal in series
+
+        inline float diffuse( float input )
+        {
+            float bufout = _buffer[ _bufIndex ];
+            undenormalise( bufout );
+
+            float stored = input + ( bufout * _feedback );
+            _buffer[ _bufIndex ] = stored;
+
+            if ( ++_bufIndex >= _bufSize ) {
+                _bufIndex = 0;
+            }
+            return bufout - ( stored * _feedback );
+        }
         void mute();
         float getFeedback();
         void setFeedback( float val );
@@ -0,0 +1,82 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "arena.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+namespace Igorski {
+
+Arena::Arena( size_t capacity )
+{
+    _capacity = sizeOf( capacity );
+
+    // over-allocate by the alignment so the start can be aligned to a cache line
+
+    _memory = new char[ _capacity + ALIGNMENT ];
+    _start  = ( char* ) ((( uintptr_t ) _memory + ALIGNMENT - 1 ) & ~(( uintptr_t ) ALIGNMENT - 1 ));
+}
+
+Arena::~Arena()
+{
+    delete[] _memory;
+}
+
+/* public methods */
+
+void* Arena::allocate( size_t bytes )
+{
+    size_t size = sizeOf( bytes );
+
+    // running out of capacity means an allocation was not accounted for when sizing the Arena, which
+    // is a programming error (checked in all builds, as the callers do not expect a failed allocation)
+
+    if ( _used + size > _capacity ) {
+        fprintf( stderr, "[Darvaza] Arena of %zu bytes cannot allocate %zu bytes (%zu in use)\n", _capacity, size, _used );
+        abort();
+    }
+    void* memory = _start + _used;
+    _used += size;
+
+    return memory;
+}
+
+size_t Arena::getCapacity()
+{
+    return _capacity;
+}
+
+size_t Arena::getUsed()
+{
+    return _used;
+}
+
+void Arena::verifyExhausted( const char* owner )
+{
+    if ( _used != _capacity ) {
+        fprintf( stderr, "[Darvaza] %s uses %zu bytes of its Arena of %zu bytes\n", owner, _used, _capacity );
+        abort();
+    }
+}
+
+}
@@ -0,0 +1,96 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __ARENA_H_INCLUDED__
+#define __ARENA_H_INCLUDED__
+
+#include <cstddef>
+
+namespace Igorski {
+
+/**
+ * An Arena reserves a single block of memory up front from which objects
+ * and arrays are allocated back to back (each on a cache line boundary)
+ * The memory is released as a whole when the Arena is deleted, objects
+ * created within the Arena must be destroyed (using destroy()) beforehand.
+ *
+ * The capacity is to be calculated in advance by summing the result of
+ * sizeOf() for all allocations, allocations beyond the capacity abort the
+ * process (in all builds) reporting the sizing error
+ */
+class Arena
+{
+    public:
+        static const size_t ALIGNMENT = 64;
+
+        Arena( size_t capacity );
+        ~Arena();
+
+        // the amount of bytes an allocation of given size occupies within the Arena
+
+        static inline size_t sizeOf( size_t bytes ) {
+            return ( bytes + ALIGNMENT - 1 ) & ~( ALIGNMENT - 1 );
+        }
+
+        template <typename T>
+        static inline size_t sizeOf( size_t count = 1 ) {
+            return sizeOf( sizeof( T ) * count );
+        }
+
+        void* allocate( size_t bytes );
+
+        // constructs an object of given type within the Arena
+
+        template <typename T, typename... Args>
+        T* create( Args&&... args );
+
+        // allocates an array of given type and length within the Arena, the
+        // values are zero-initialized
+
+        template <typename T>
+        T* createArray( size_t count );
+
+        // invokes the destructor of an object created within the Arena (its memory
+        // is only released when the Arena itself is deleted)
+
+        template <typename T>
+        static void destroy( T* object );
+
+        size_t getCapacity();
+        size_t getUsed();
+
+        // aborts when the capacity is not used entirely, e.g. when an allocation accounted
+        // for in the capacity was omitted (owner describes the Arena in the report)
+
+        void verifyExhausted( const char* owner );
+
+    private:
+        char*  _memory;
+        char*  _start; // _memory aligned to ALIGNMENT
+        size_t _capacity;
+        size_t _used = 0;
+};
+}
+
+#include "arena.tcc"
+
+#endif
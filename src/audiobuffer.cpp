@@ -21,7 +21,10 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "audiobuffer.h"
+#include "vectorops.h"
 #include <algorithm>
+#include <math.h>
+#include <stdint.h>
 #include <string.h>
 
 AudioBuffer::AudioBuffer( int aAmountOfChannels, int aBufferSize )
@@ -30,36 +33,36 @@ AudioBuffer::AudioBuffer( int aAmountOfChannels, int aBufferSize )
     amountOfChannels = aAmountOfChannels;
     bufferSize       = aBufferSize;
 
-    // create silent buffers for each channel
+    // pad each channel to a multiple of the alignment so all channels start aligned
 
-    _buffers = new std::vector<float*>( amountOfChannels );
+    const int alignedFloats = ALIGNMENT / sizeof( float );
+    _channelStride = (( aBufferSize + alignedFloats - 1 ) / alignedFloats ) * alignedFloats;
+
+    // allocate all channels at once (with room to align the start of the first channel)
+    // the peaks of each channel are stored after the last channel
+
+    size_t size = ( size_t ) _channelStride * amountOfChannels;
+    _memory     = new float[ size + alignedFloats + amountOfChannels ];
+
+    uintptr_t address = reinterpret_cast<uintptr_t>( _memory );
+    _channels = reinterpret_cast<float*>(( address + ALIGNMENT - 1 ) & ~( uintptr_t ) ( ALIGNMENT - 1 ));
+    _peaks    = _channels + size;
 
     // fill buffers with silence
 
-    for ( int i = 0; i < amountOfChannels; ++i ) {
-        _buffers->at( i ) = new float[ aBufferSize ];
-        memset( _buffers->at( i ), 0, aBufferSize * sizeof( float )); // zero bits should equal 0.f
-    }
+    memset( _channels, 0, ( size + amountOfChannels ) * sizeof( float )); // zero bits should equal 0.f
 }
 
 AudioBuffer::~AudioBuffer()
 {
-    while ( !_buffers->empty()) {
-        delete[] _buffers->back(), _buffers->pop_back();
-    }
-    delete _buffers;
+    delete[] _memory;
 }
 
 /* public methods */
 
-float* AudioBuffer::getBufferForChannel( int aChannelNum )
-{
-    return _buffers->at( aChannelNum );
-}
-
 int AudioBuffer::mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWriteOffset, float aMixVolume )
 {
-    if ( aBuffer == 0 || aWriteOffset >= bufferSize )
+    if ( aBuffer == 0 || aWriteOffset >= bufferSize || aBuffer->bufferSize <= 0 )
         return 0;
 
     int sourceLength     = aBuffer->bufferSize;
@@ -72,7 +75,6 @@ int AudioBuffer::mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWrite
     if (( aWriteOffset + writeLength ) >= bufferSize )
         writeLength = bufferSize - aWriteOffset;
 
-    int maxWriteOffset = aWriteOffset + writeLength;
     int c;
 
     for ( c = 0; c < amountOfChannels; ++c )
@@ -83,7 +85,14 @@ int AudioBuffer::mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWrite
         float* srcBuffer    = aBuffer->getBufferForChannel( c );
         float* targetBuffer = getBufferForChannel( c );
 
-        for ( int i = aWriteOffset, r = aReadOffset; i < maxWriteOffset; ++i, ++r )
+        // merge in contiguous spans, only splitting where the source wraps around when
+        // loopeable (e.g. two spans at most when the source is at least as long as this buffer)
+
+        int r = aReadOffset;
+        int i = aWriteOffset;
+        int remaining = writeLength;
+
+        while ( remaining > 0 )
         {
             if ( r >= sourceLength )
             {
@@ -92,8 +101,14 @@ int AudioBuffer::mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWrite
                 else
                     break;
             }
-            targetBuffer[ i ] += ( srcBuffer[ r ] * aMixVolume );
-            ++writtenSamples;
+            int span = std::min( remaining, sourceLength - r );
+
+            mergeSpan( srcBuffer + r, targetBuffer + i, aMixVolume, span, c );
+
+            r += span;
+            i += span;
+            remaining      -= span;
+            writtenSamples += span;
         }
     }
     // return the amount of samples written (per buffer)
@@ -106,30 +121,43 @@ int AudioBuffer::mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWrite
  */
 void AudioBuffer::silenceBuffers()
 {
-    // use mem set to quickly erase existing buffer contents, zero bits should equal 0.f
-    for ( int i = 0; i < amountOfChannels; ++i )
-        memset( getBufferForChannel( i ), 0, bufferSize * sizeof( float ));
+    // as all channels are contiguous, a single memset erases all existing contents
+    // (including the tracked peaks), zero bits should equal 0.f
+    memset( _channels, 0, (( size_t ) _channelStride * amountOfChannels + amountOfChannels ) * sizeof( float ));
 }
 
 void AudioBuffer::adjustBufferVolumes( float amp )
 {
-    for ( int i = 0; i < amountOfChannels; ++i )
-    {
-        float* buffer = getBufferForChannel( i );
+    // the padding between channels is silent, so all channels can be processed at once
 
-        for ( int j = 0; j < bufferSize; ++j )
-            buffer[ j ] *= amp;
-    }
+    Igorski::VectorOps::scale( _channels, amp, _channelStride * amountOfChannels );
+
+    for ( int i = 0; i < amountOfChannels; ++i )
+        _peaks[ i ] *= fabs( amp );
 }
 
 bool AudioBuffer::isSilent()
 {
+    if ( _peakTracking )
+    {
+        for ( int i = 0; i < amountOfChannels; ++i )
+        {
+            if ( _peaks[ i ] != 0.f )
+                return false;
+        }
+        return true;
+    }
+
+    // scan in chunks so non-silent content is detected without scanning the whole buffer
+
+    const int chunkSize = 256;
+
     for ( int i = 0; i < amountOfChannels; ++i )
     {
         float* buffer = getBufferForChannel( i );
-        for ( int j = 0; j < bufferSize; ++j )
+        for ( int j = 0; j < bufferSize; j += chunkSize )
         {
-            if ( buffer[ j ] != 0.f )
+            if ( Igorski::VectorOps::peak( buffer + j, std::min( chunkSize, bufferSize - j )) != 0.f )
                 return false;
         }
     }
@@ -140,12 +168,35 @@ AudioBuffer* AudioBuffer::clone()
 {
     AudioBuffer* output = new AudioBuffer( amountOfChannels, bufferSize );
 
-    for ( int i = 0; i < amountOfChannels; ++i )
-    {
-        float* sourceBuffer = getBufferForChannel( i );
-        float* targetBuffer = output->getBufferForChannel( i );
+    // copies the channels and tracked peaks at once (the layout of the clone is equal)
+    memcpy( output->_channels, _channels, (( size_t ) _channelStride * amountOfChannels + amountOfChannels ) * sizeof( float ));
+    output->_peakTracking = _peakTracking;
 
-        memcpy( targetBuffer, sourceBuffer, bufferSize * sizeof( float ));
-    }
     return output;
 }
+
+void AudioBuffer::setPeakTracking( bool enabled )
+{
+    _peakTracking = enabled;
+
+    if ( !enabled )
+        return;
+
+    for ( int i = 0; i < amountOfChannels; ++i )
+        _peaks[ i ] = Igorski::VectorOps::peak( getBufferForChannel( i ), bufferSize );
+}
+
+float AudioBuffer::getPeak( int aChannelNum )
+{
+    return _peakTracking ? _peaks[ aChannelNum ] : Igorski::VectorOps::peak( getBufferForChannel( aChannelNum ), bufferSize );
+}
+
+/* protected methods */
+
+void AudioBuffer::mergeSpan( const float* source, float* target, float volume, int length, int aChannelNum )
+{
+    Igorski::VectorOps::mix( source, target, volume, length );
+
+    if ( _peakTracking )
+        updatePeak( aChannelNum, Igorski::VectorOps::peak( target, length ));
+}
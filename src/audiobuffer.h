@@ -24,12 +24,14 @@
 #define __AUDIOBUFFER_H_INCLUDED__
 
 #include "global.h"
-#include <vector>
 
 /**
  * An AudioBuffer represents multiple channels of audio
  * each of equal buffer length.
  * AudioBuffer has convenience methods for cloning, silencing and mixing
+ *
+ * All channels are stored in a single allocation where each channel starts
+ * on a cache line boundary, so vectorized kernels can rely on aligned loads
  */
 class AudioBuffer
 {
@@ -41,15 +43,42 @@ class AudioBuffer
         int bufferSize;
         bool loopeable;
 
-        float* getBufferForChannel( int aChannelNum );
+        // NOTE : no bounds checking takes place, aChannelNum must be below amountOfChannels
+
+        inline float* getBufferForChannel( int aChannelNum ) {
+            return _channels + aChannelNum * _channelStride;
+        }
+
         int mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWriteOffset, float aMixVolume );
         void silenceBuffers();
         void adjustBufferVolumes( float volume );
         bool isSilent();
         AudioBuffer* clone();
 
+        // when peak tracking is enabled, the methods above keep track of the peak of each channel
+        // (as an upper bound) so isSilent() doesn't need to scan the buffer contents. Content written
+        // directly into the channel buffers must be reported through updatePeak() by its writer
+
+        void setPeakTracking( bool enabled );
+
+        inline void updatePeak( int aChannelNum, float peak ) {
+            if ( _peakTracking && peak > _peaks[ aChannelNum ]) {
+                _peaks[ aChannelNum ] = peak;
+            }
+        }
+
+        float getPeak( int aChannelNum );
+
+        static const int ALIGNMENT = 64; // in bytes, equal to a cache line (and the widest SIMD register)
+
     protected:
-        std::vector<float*>* _buffers;
+        float* _memory;       // allocated memory, which is not necessarily aligned
+        float* _channels;     // start of the first channel within _memory
+        int    _channelStride; // distance between channels, the buffer size padded to the alignment
+        float* _peaks;         // tracked peak per channel (stored after the last channel)
+        bool   _peakTracking = false;
+
+        void mergeSpan( const float* source, float* target, float volume, int length, int aChannelNum );
 };
 
 #endif
@@ -44,24 +44,6 @@ BitCrusher::~BitCrusher()
 
 /* public methods */
 
-void BitCrusher::process( float* inBuffer, int bufferSize )
-{
-    // sound should not be crushed ? do nothing
-    if ( !isActive() ) {
-        return;
-    }
-    
-    int bitsPlusOne = _bits + 1;
-
-    for ( int i = 0; i < bufferSize; ++i )
-    {
-        short input = ( short ) (( inBuffer[ i ] * _inputMix ) * SHRT_MAX );
-        short prevent_offset = ( short )( -1 >> bitsPlusOne );
-        input &= ( -1 << ( 16 - _bits ));
-        inBuffer[ i ] = (( input + prevent_offset ) * _outputMix ) / SHRT_MAX;
-    }
-}
-
 /* setters */
 
 void BitCrusher::setAmount( float value )
@@ -23,6 +23,12 @@
 #ifndef __BITCRUSHER_H_INCLUDED__
 #define __BITCRUSHER_H_INCLUDED__
 
+#include "snd.h"
+#include "vectorops.h"
+#include <limits.h>
+#include <math.h>
+#include <type_traits>
+
 namespace Igorski {
 class BitCrusher {
 
@@ -30,7 +36,18 @@ class BitCrusher {
         BitCrusher( float amount, float inputMix, float outputMix );
         ~BitCrusher();
 
-        void process( float* inBuffer, int bufferSize );
+        // quantizes the contents of inBuffer in place, processing whole blocks at a time
+
+        template <typename SampleType>
+        void process( SampleType* inBuffer, int bufferSize );
+
+        // quantizes the contents of inBuffer in place at OVERSAMPLING times the sample rate (the
+        // input is linearly interpolated and the quantized result averaged back down), which reduces
+        // the aliasing of the quantization at a multiple of the CPU cost. lastInput must hold the
+        // last unprocessed input sample of the previous block of the same channel and is updated
+
+        template <typename SampleType>
+        void processOversampled( SampleType* inBuffer, int bufferSize, float& lastInput );
 
         void setAmount( float value ); // range between -1 to +1
         void setInputMix( float value );
@@ -47,7 +64,23 @@ class BitCrusher {
         float _outputMix;
 
         void calcBits();
+
+        // the quantization of a single sample, the SIMD path in process() is equivalent
+
+        template <typename SampleType>
+        inline SampleType crushSample( SampleType sample, int mask ) {
+            // clamp to the 16-bit range, so out of range input saturates instead of wrapping around
+            float scaled = fmin(( float ) SHRT_MAX, fmax(( float ) SHRT_MIN, ( float ) ( sample * _inputMix ) * SHRT_MAX ));
+            int input    = (( int ) scaled ) & mask;
+
+            return ( SampleType ) ((( input + PREVENT_OFFSET ) * _outputMix ) / SHRT_MAX );
+        }
+
+        static const int PREVENT_OFFSET = -1;
+        static const int OVERSAMPLING   = 4;
 };
 }
 
+#include "bitcrusher.tcc"
+
 #endif
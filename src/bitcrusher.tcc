@@ -0,0 +1,109 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <math.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace Igorski {
+
+template <typename SampleType>
+void BitCrusher::process( SampleType* inBuffer, int bufferSize )
+{
+    // sound should not be crushed ? do nothing
+    if ( !isActive() ) {
+        return;
+    }
+
+    // the bit reduction masks the lowest bits of the 16-bit representation
+    // of the signal (note -1 >> n always equals -1, hence the constant offset)
+
+    int mask = -1 << ( 16 - _bits );
+    int i    = 0;
+
+#ifdef __SSE2__
+    if ( std::is_same<SampleType, float>::value && !VectorOps::forceScalar ) {
+        float* buffer = ( float* ) inBuffer;
+
+        const __m128  inputMix  = _mm_set1_ps( _inputMix );
+        const __m128  outputMix = _mm_set1_ps( _outputMix );
+        const __m128  maxValue  = _mm_set1_ps(( float ) SHRT_MAX );
+        const __m128  minValue  = _mm_set1_ps(( float ) SHRT_MIN );
+        const __m128i maskValue = _mm_set1_epi32( mask );
+        const __m128i offset    = _mm_set1_epi32( PREVENT_OFFSET );
+
+        for ( ; i + 4 <= bufferSize; i += 4 ) {
+            __m128 scaled = _mm_mul_ps( _mm_mul_ps( _mm_loadu_ps( buffer + i ), inputMix ), maxValue );
+            scaled = _mm_min_ps( maxValue, _mm_max_ps( minValue, scaled ));
+
+            // truncate to integer, apply the mask and convert back
+
+            __m128i input = _mm_and_si128( _mm_cvttps_epi32( scaled ), maskValue );
+            __m128 output = _mm_cvtepi32_ps( _mm_add_epi32( input, offset ));
+
+            _mm_storeu_ps( buffer + i, _mm_div_ps( _mm_mul_ps( output, outputMix ), maxValue ));
+        }
+    }
+#endif
+
+    // remaining samples (and 64-bit buffers) are quantized in a loop that is free of
+    // branches and type conversions to short, so it can be auto-vectorized
+
+    for ( ; i < bufferSize; ++i ) {
+        inBuffer[ i ] = crushSample<SampleType>( inBuffer[ i ], mask );
+    }
+}
+
+template <typename SampleType>
+void BitCrusher::processOversampled( SampleType* inBuffer, int bufferSize, float& lastInput )
+{
+    if ( !isActive() ) {
+        if ( bufferSize > 0 ) {
+            lastInput = ( float ) inBuffer[ bufferSize - 1 ];
+        }
+        return;
+    }
+
+    int mask = -1 << ( 16 - _bits );
+    const float step = 1.f / OVERSAMPLING;
+
+    float previous = lastInput;
+
+    for ( int i = 0; i < bufferSize; ++i ) {
+        float current = ( float ) inBuffer[ i ];
+        float delta   = current - previous;
+        float sum     = 0.f;
+
+        // the intermediate positions between the previous and current sample (ending at the latter)
+
+        for ( int j = 1; j <= OVERSAMPLING; ++j ) {
+            sum += crushSample<float>( previous + delta * ( step * j ), mask );
+        }
+        inBuffer[ i ] = ( SampleType ) ( sum * step ); // average back down to the sample rate
+        previous = current;
+    }
+    lastInput = previous;
+}
+
+}
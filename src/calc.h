@@ -40,20 +40,20 @@ namespace Calc {
 
     /**
      * convert given value in seconds to the appropriate
-     * value in samples (for the current sampling rate)
+     * value in samples (for given sampling rate)
      */
-    inline int secondsToBuffer( float seconds )
+    inline int secondsToBuffer( float seconds, float sampleRate )
     {
-        return ( int )( seconds * Igorski::VST::SAMPLE_RATE );
+        return ( int )( seconds * sampleRate );
     }
 
     /**
      * convert given value in milliseconds to the appropriate
-     * value in samples (for the current sampling rate)
+     * value in samples (for given sampling rate)
      */
-    inline int millisecondsToBuffer( float milliseconds )
+    inline int millisecondsToBuffer( float milliseconds, float sampleRate )
     {
-        return secondsToBuffer( milliseconds / 1000.f );
+        return secondsToBuffer( milliseconds / 1000.f, sampleRate );
     }
 
     // convenience method to ensure given value is within the 0.f - +1.f range
@@ -108,6 +108,26 @@ namespace Calc {
         return ( float ) ( std::min( maxValue, value ) * ratio );
     }
 
+    // 4-point, 3rd order Hermite interpolation between samples s1 and s2 at given
+    // fraction (in the 0 - 1 range), s0 and s3 being the samples surrounding these
+
+    inline float hermite( float s0, float s1, float s2, float s3, float frac )
+    {
+        float c1 = .5f * ( s2 - s0 );
+        float c2 = s0 - 2.5f * s1 + 2.f * s2 - .5f * s3;
+        float c3 = .5f * ( s3 - s0 ) + 1.5f * ( s1 - s2 );
+
+        return (( c3 * frac + c2 ) * frac + c1 ) * frac + s1;
+    }
+
+    // scales given normalized (0 - 1 range) value exponentially into the min - max
+    // range (min must be larger than 0), suited for time and frequency values
+
+    inline float scaleExponential( float value, float min, float max )
+    {
+        return min * powf( max / min, value );
+    }
+
     // cast a floating point value to a boolean true/false
 
     inline bool toBool( float value )
@@ -32,8 +32,9 @@
 
  void Comb::setBuffer( float *buf, int size )
  {
-     _buffer  = buf;
-     _bufSize = size;
+     _buffer   = buf;
+     _bufSize  = size;
+     _bufIndex = 0;
  }
 
  void Comb::mute()
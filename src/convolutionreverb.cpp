@@ -0,0 +1,337 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "convolutionreverb.h"
+#include <algorithm>
+#include <string.h>
+
+namespace Igorski {
+
+/* Stage */
+
+ConvolutionReverb::Stage::Stage( const float* impulseResponse, int length, int blockSize, int firstPartition, int lastPartition, int amountOfSteps )
+{
+    _blockSize          = blockSize;
+    _binCount           = blockSize + 1;
+    _firstPartition     = firstPartition;
+    _amountOfPartitions = lastPartition - firstPartition;
+    _amountOfSteps      = amountOfSteps;
+    _stepSize           = blockSize / amountOfSteps;
+
+    // spreading the calculation over the next block requires the range to start a block later
+
+    _delay = ( amountOfSteps > 1 ) ? 2 : 1;
+
+    _fft = new FFT( blockSize * 2 );
+
+    // the delay line must reach back as far as the last partition (relative to the newest block)
+
+    _fdlSize = lastPartition - _delay;
+
+    int spectrumSize = _binCount * _amountOfPartitions;
+    int fdlMemory    = _binCount * _fdlSize;
+    int memorySize   = spectrumSize * 2 + fdlMemory * 2 + _binCount * 2 + blockSize * 2 * 4 + blockSize * 2;
+
+    _memory = new float[ memorySize ];
+    memset( _memory, 0, memorySize * sizeof( float ));
+
+    _partitionsReal = _memory;
+    _partitionsImag = _partitionsReal + spectrumSize;
+    _fdlReal        = _partitionsImag + spectrumSize;
+    _fdlImag        = _fdlReal + fdlMemory;
+    _accReal        = _fdlImag + fdlMemory;
+    _accImag        = _accReal + _binCount;
+    _workReal       = _accImag + _binCount;
+    _workImag       = _workReal + blockSize * 2;
+    _input          = _workImag + blockSize * 2;
+    _spreadInput    = _input + blockSize * 2;
+    _output         = _spreadInput + blockSize * 2;
+    _nextOutput     = _output + blockSize;
+
+    // transform each partition of the response (zero padded to twice the block size)
+
+    float* padded = _input; // input is still silent and can serve as the padding buffer
+
+    for ( int p = 0; p < _amountOfPartitions; ++p ) {
+        int offset = ( firstPartition + p ) * blockSize;
+        int amount = std::max( 0, std::min( blockSize, length - offset ));
+
+        memset( padded, 0, blockSize * 2 * sizeof( float ));
+        if ( amount > 0 ) {
+            memcpy( padded, impulseResponse + offset, amount * sizeof( float ));
+        }
+        _fft->forwardReal( padded, _workReal, _workImag );
+
+        memcpy( _partitionsReal + p * _binCount, _workReal, _binCount * sizeof( float ));
+        memcpy( _partitionsImag + p * _binCount, _workImag, _binCount * sizeof( float ));
+    }
+    memset( padded, 0, blockSize * 2 * sizeof( float ));
+}
+
+ConvolutionReverb::Stage::~Stage()
+{
+    delete _fft;
+    delete[] _memory;
+}
+
+void ConvolutionReverb::Stage::mute()
+{
+    memset( _fdlReal,     0, _binCount * _fdlSize * sizeof( float ));
+    memset( _fdlImag,     0, _binCount * _fdlSize * sizeof( float ));
+    memset( _accReal,     0, _binCount * sizeof( float ));
+    memset( _accImag,     0, _binCount * sizeof( float ));
+    memset( _input,       0, _blockSize * 2 * sizeof( float ));
+    memset( _spreadInput, 0, _blockSize * 2 * sizeof( float ));
+    memset( _output,      0, _blockSize * sizeof( float ));
+    memset( _nextOutput,  0, _blockSize * sizeof( float ));
+}
+
+void ConvolutionReverb::Stage::completeBlock()
+{
+    if ( _amountOfSteps == 1 ) {
+        transformInput( _input );
+        accumulate( 0, _amountOfPartitions );
+        inverseTransform( _output );
+    } else {
+        // the output calculated over the course of the previous block is now due, start
+        // calculating the output for the next block (using the blocks received up to now)
+
+        std::swap( _output, _nextOutput );
+        memcpy( _spreadInput, _input, _blockSize * 2 * sizeof( float ));
+
+        _step = 0;
+        processStep();
+    }
+    memcpy( _input, _input + _blockSize, _blockSize * sizeof( float ));
+}
+
+void ConvolutionReverb::Stage::processStep()
+{
+    // the first step transforms the input, the last step transforms the result back to the
+    // time domain and the steps in between each accumulate an equal share of the partitions
+
+    int lastStep = _amountOfSteps - 1;
+
+    if ( _step == 0 ) {
+        transformInput( _spreadInput );
+    } else if ( _step < lastStep ) {
+        int partitionsPerStep = ( _amountOfPartitions + lastStep - 2 ) / ( lastStep - 1 );
+        int first = std::min( _amountOfPartitions, ( _step - 1 ) * partitionsPerStep );
+        int last  = std::min( _amountOfPartitions, first + partitionsPerStep );
+
+        accumulate( first, last );
+    } else if ( _step == lastStep ) {
+        inverseTransform( _nextOutput );
+    }
+    ++_step;
+}
+
+void ConvolutionReverb::Stage::transformInput( const float* input )
+{
+    // transform the last two input blocks into the newest slot of the delay line
+
+    _fft->forwardReal( input, _workReal, _workImag );
+    memcpy( _fdlReal + _fdlIndex * _binCount, _workReal, _binCount * sizeof( float ));
+    memcpy( _fdlImag + _fdlIndex * _binCount, _workImag, _binCount * sizeof( float ));
+
+    memset( _accReal, 0, _binCount * sizeof( float ));
+    memset( _accImag, 0, _binCount * sizeof( float ));
+}
+
+void ConvolutionReverb::Stage::accumulate( int firstPartition, int lastPartition )
+{
+    // partition n of the response applies to the input block that arrived n blocks ago
+
+    for ( int p = firstPartition; p < lastPartition; ++p ) {
+        int slot = _fdlIndex - ( _firstPartition + p - _delay );
+        if ( slot < 0 ) {
+            slot += _fdlSize;
+        }
+        FFT::multiplyAccumulate(
+            _partitionsReal + p * _binCount, _partitionsImag + p * _binCount,
+            _fdlReal + slot * _binCount, _fdlImag + slot * _binCount,
+            _accReal, _accImag, _binCount
+        );
+    }
+}
+
+void ConvolutionReverb::Stage::inverseTransform( float* output )
+{
+    if ( ++_fdlIndex == _fdlSize ) {
+        _fdlIndex = 0;
+    }
+
+    // back to the time domain, with overlap-save only the last block is free of circular aliasing
+
+    memcpy( _workReal, _accReal, _binCount * sizeof( float ));
+    memcpy( _workImag, _accImag, _binCount * sizeof( float ));
+    _fft->inverseReal( _workReal, _workImag, _workReal );
+
+    memcpy( output, _workReal + _blockSize, _blockSize * sizeof( float ));
+}
+
+/* ConvolutionReverb */
+
+ConvolutionReverb::ConvolutionReverb( const float* impulseResponse, int length )
+{
+    for ( int i = 0; i < HEAD_SIZE; ++i ) {
+        _head[ HEAD_SIZE - 1 - i ] = ( i < length ) ? impulseResponse[ i ] : 0.f;
+    }
+    memset( _history, 0, HEAD_SIZE * 2 * sizeof( float ));
+
+    // the small partitions cover the response up to the first large partition, the large
+    // partitions cover the remainder (each stage starts after its first block, as the
+    // output for a block is only calculated once the block has been received in full,
+    // the large stage starts a block later still as it calculates its output in steps)
+
+    int largeStart = LARGE_PARTITION * LARGE_OFFSET;
+
+    if ( length > HEAD_SIZE ) {
+        int lastPartition = std::min( largeStart, length + SMALL_PARTITION - 1 ) / SMALL_PARTITION;
+        _smallStage = new Stage( impulseResponse, length, SMALL_PARTITION, HEAD_SIZE / SMALL_PARTITION, lastPartition );
+    }
+    if ( length > largeStart ) {
+        int lastPartition = ( length + LARGE_PARTITION - 1 ) / LARGE_PARTITION;
+        _largeStage = new Stage( impulseResponse, length, LARGE_PARTITION, LARGE_OFFSET, lastPartition, LARGE_STEPS );
+    }
+
+    _tail = new float[ FREEZE_SIZE ];
+    memset( _tail, 0, FREEZE_SIZE * sizeof( float ));
+
+    setWet ( INITIAL_WET );
+    setDry ( INITIAL_DRY );
+    setMode( INITIAL_MODE );
+}
+
+ConvolutionReverb::~ConvolutionReverb()
+{
+    delete _smallStage;
+    delete _largeStage;
+    delete[] _tail;
+}
+
+void ConvolutionReverb::process( float* inBuffer, int bufferSize )
+{
+    for ( int i = 0; i < bufferSize; ++i ) {
+        inBuffer[ i ] = processSingle( inBuffer[ i ]);
+    }
+}
+
+void ConvolutionReverb::mute()
+{
+    if ( getMode() >= FREEZE_MODE ) {
+        return;
+    }
+
+    memset( _history, 0, HEAD_SIZE * 2 * sizeof( float ));
+
+    if ( _smallStage != nullptr ) {
+        _smallStage->mute();
+    }
+    if ( _largeStage != nullptr ) {
+        _largeStage->mute();
+    }
+    memset( _tail, 0, FREEZE_SIZE * sizeof( float ));
+    _loopLevel = 0.f;
+}
+
+float ConvolutionReverb::getWet()
+{
+    return _wet;
+}
+
+void ConvolutionReverb::setWet( float value )
+{
+    _wet = value;
+}
+
+float ConvolutionReverb::getDry()
+{
+    return _dry;
+}
+
+void ConvolutionReverb::setDry( float value )
+{
+    _dry = value;
+}
+
+float ConvolutionReverb::getMode()
+{
+    return ( _mode >= FREEZE_MODE ) ? 1 : 0;
+}
+
+void ConvolutionReverb::setMode( float value )
+{
+    _mode = value;
+
+    bool frozen = _mode >= FREEZE_MODE;
+
+    // when frozen, no new input enters the reverb and the recorded tail is looped (when
+    // freezing again while the loop is still fading out, the same loop continues)
+
+    if ( frozen && !_frozen && _loopLevel == 0.f ) {
+        _loopStart    = _tailIndex;
+        _loopPosition = 0;
+    }
+    _frozen = frozen;
+    _gain   = frozen ? MUTED : 1.f;
+}
+
+float ConvolutionReverb::processFrozen( float processedSample )
+{
+    // the loop is shorter than the recording, the samples following the end of the loop
+    // are faded into the start of the loop, so wrapping around does not cause a discontinuity
+
+    const int loopLength = FREEZE_SIZE - FREEZE_FADE;
+
+    int index = _loopStart + _loopPosition;
+    if ( index >= FREEZE_SIZE ) {
+        index -= FREEZE_SIZE;
+    }
+    float loopSample = _tail[ index ];
+
+    if ( _loopPosition < FREEZE_FADE ) {
+        int continued = index + loopLength;
+        if ( continued >= FREEZE_SIZE ) {
+            continued -= FREEZE_SIZE;
+        }
+        float fade = ( float ) _loopPosition / FREEZE_FADE;
+        loopSample = loopSample * fade + _tail[ continued ] * ( 1.f - fade );
+    }
+    if ( ++_loopPosition == loopLength ) {
+        _loopPosition = 0;
+    }
+
+    // crossfade between the convolution and the loop when (un)freezing
+
+    const float fadeStep = 1.f / FREEZE_FADE;
+    _loopLevel = _frozen ? std::min( 1.f, _loopLevel + fadeStep ) : std::max( 0.f, _loopLevel - fadeStep );
+
+    return processedSample * ( 1.f - _loopLevel ) + loopSample * _loopLevel;
+}
+
+void ConvolutionReverb::toggleFreeze()
+{
+    setMode( getMode() == 1 ? INITIAL_MODE : FREEZE_MODE );
+}
+
+}
@@ -0,0 +1,211 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __CONVOLUTIONREVERB__H_INCLUDED__
+#define __CONVOLUTIONREVERB__H_INCLUDED__
+
+#include "global.h"
+#include "fft.h"
+
+using namespace Steinberg;
+
+namespace Igorski {
+
+/**
+ * Reverb convolving its input with a recorded impulse response, sharing the public
+ * interface of the algorithmic Reverb. To keep long impulse responses affordable the
+ * response is non-uniformly partitioned : the first HEAD_SIZE taps are convolved
+ * directly (so there is no latency), the remaining taps are convolved in the frequency
+ * domain in partitions that grow in size the further they are into the response.
+ * The large partitions start two blocks into the response, which leaves a full block
+ * of time to calculate their output, so that work is spread evenly over the samples
+ * of the block instead of taking place all at once.
+ *
+ * As a response cannot be fed back into itself the way the algorithmic reverbs sustain
+ * their tail, freezing loops the most recently rendered FREEZE_SIZE samples of the tail
+ */
+class ConvolutionReverb {
+
+    static const int HEAD_SIZE       = 64;    // amount of taps convolved in the time domain
+    static const int SMALL_PARTITION = 64;    // partition size for the early part of the response
+    static const int LARGE_PARTITION = 1024;  // partition size for the remainder of the response
+    static const int LARGE_OFFSET    = 2;     // the first large partition, in units of LARGE_PARTITION
+    static const int LARGE_STEPS     = 16;    // amount of steps the work of a large block is spread over
+    static const int FREEZE_SIZE     = 32768; // length of the recorded tail looped when frozen
+    static const int FREEZE_FADE     = 2048;  // length of the crossfade at the seam of the loop (and when (un)freezing)
+
+    static constexpr float MUTED         = 0;
+    static constexpr float INITIAL_WET   = 1;
+    static constexpr float INITIAL_DRY   = 0;
+    static constexpr float INITIAL_MODE  = 0;
+    static constexpr float FREEZE_MODE   = 0.5f;
+
+    /**
+     * Uniformly partitioned overlap-save convolution of a range of the impulse response
+     * (starting at a multiple of the block size, after the first block). Each block of
+     * input is transformed once and kept in a frequency-domain delay line, from which
+     * the output for the next block is accumulated when the current block completes.
+     * When the range starts after the second block, the output is calculated one block
+     * ahead, spread over the given amount of steps (see processStep())
+     */
+    class Stage {
+        public:
+            Stage( const float* impulseResponse, int length, int blockSize, int firstPartition, int lastPartition, int amountOfSteps = 1 );
+            ~Stage();
+
+            inline float processSingle( float inputSample ) {
+                float output = _output[ _position ];
+                _input[ _blockSize + _position ] = inputSample;
+
+                if ( ++_position == _blockSize ) {
+                    _position = 0;
+                    completeBlock();
+                } else if ( _amountOfSteps > 1 && ( _position % _stepSize ) == 0 ) {
+                    processStep();
+                }
+                return output;
+            }
+
+            void mute();
+
+        private:
+            int _blockSize;
+            int _binCount;       // amount of unique bins for a real valued transform of twice the block size
+            int _firstPartition;
+            int _amountOfPartitions;
+            int _position = 0;
+            int _fdlIndex = 0;
+            int _fdlSize;
+            int _delay;          // amount of blocks between an input block and its first contribution to the output
+            int _amountOfSteps;
+            int _stepSize;
+            int _step = 0;
+
+            FFT* _fft;
+            float* _memory;      // single allocation holding all buffers below
+            float* _partitionsReal;
+            float* _partitionsImag;
+            float* _fdlReal;     // frequency-domain delay line, one spectrum per partition
+            float* _fdlImag;
+            float* _accReal;
+            float* _accImag;
+            float* _workReal;
+            float* _workImag;
+            float* _input;       // previous and current input block
+            float* _output;      // output for the current block
+            float* _nextOutput;  // output for the next block, while it is being calculated
+            float* _spreadInput; // copy of the input blocks transformed by the current spread calculation
+
+            void completeBlock();
+            void processStep();
+            void transformInput( const float* input );
+            void accumulate( int firstPartition, int lastPartition );
+            void inverseTransform( float* output );
+    };
+
+    public:
+        ConvolutionReverb( const float* impulseResponse, int length );
+        ~ConvolutionReverb();
+
+        // apply effect to incoming sampleBuffer contents
+
+        void process( float* inBuffer, int bufferSize );
+
+        inline float processSingle( float inputSample ) {
+
+            inputSample *= _gain;
+
+            // direct convolution of the head of the response, the history is written twice
+            // so the last HEAD_SIZE samples are always available as a contiguous range
+
+            _history[ _historyIndex ] = inputSample;
+            _history[ _historyIndex + HEAD_SIZE ] = inputSample;
+
+            if ( ++_historyIndex == HEAD_SIZE ) {
+                _historyIndex = 0;
+            }
+
+            const float* window = _history + _historyIndex;
+            float processedSample = 0;
+
+            for ( int i = 0; i < HEAD_SIZE; ++i ) {
+                processedSample += window[ i ] * _head[ i ];
+            }
+
+            // frequency-domain convolution of the remainder of the response
+
+            if ( _smallStage != nullptr ) {
+                processedSample += _smallStage->processSingle( inputSample );
+            }
+            if ( _largeStage != nullptr ) {
+                processedSample += _largeStage->processSingle( inputSample );
+            }
+
+            // when frozen, the recorded tail is looped in place of the (decaying) convolution
+
+            if ( _frozen || _loopLevel > 0.f ) {
+                processedSample = processFrozen( processedSample );
+            } else {
+                _tail[ _tailIndex ] = processedSample;
+                if ( ++_tailIndex == FREEZE_SIZE ) {
+                    _tailIndex = 0;
+                }
+            }
+
+            // wet mix (e.g. the reverberated signal) and dry mix (e.g. mix in the input signal)
+            return ( processedSample * _wet ) + ( inputSample * _dry );
+        }
+
+        void mute();
+        void setWet( float value );
+        float getWet();
+        void setDry( float value );
+        float getDry();
+        float getMode();
+        void setMode( float value );
+        void toggleFreeze();
+
+    private:
+        float _gain;
+        float _wet;
+        float _dry;
+        float _mode;
+
+        alignas( 16 ) float _head[ HEAD_SIZE ];          // head of the response, in reverse order
+        alignas( 16 ) float _history[ HEAD_SIZE * 2 ];
+        int _historyIndex = 0;
+
+        Stage* _smallStage = nullptr;
+        Stage* _largeStage = nullptr;
+
+        float* _tail;         // ring buffer of the most recently rendered output
+        int _tailIndex    = 0;
+        int _loopStart    = 0;
+        int _loopPosition = 0;
+        bool _frozen      = false;
+        float _loopLevel  = 0.f; // mix of the loop relative to the convolution output
+
+        float processFrozen( float processedSample );
+};
+}
+
+#endif
@@ -0,0 +1,199 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "deadlinemonitor.h"
+#include <algorithm>
+#include <math.h>
+
+namespace Igorski {
+
+/* constructor */
+
+DeadlineMonitor::DeadlineMonitor( float sampleRate )
+{
+    setSampleRate( sampleRate );
+    reset();
+}
+
+/* public methods */
+
+void DeadlineMonitor::measure( Clock::time_point start, int bufferSize )
+{
+    if ( bufferSize <= 0 ) {
+        return;
+    }
+
+    float elapsed = std::chrono::duration<float>( Clock::now() - start ).count();
+    float load    = elapsed / ( bufferSize / _sampleRate );
+
+    if ( _governorEnabled ) {
+        if ( load > 1.f ) {
+            ++_overruns;
+        }
+        if ( load > NEAR_MISS_LOAD ) {
+            ++_nearMisses;
+        }
+    }
+
+    // replace the oldest load within the window
+
+    int bin = std::min( AMOUNT_OF_BINS - 1, ( int ) ( load / MAX_LOAD * AMOUNT_OF_BINS ));
+
+    if ( _windowCount == WINDOW_SIZE ) {
+        --_histogram[ _window[ _windowIndex ]];
+    } else {
+        ++_windowCount;
+    }
+    _window[ _windowIndex ] = bin;
+    ++_histogram[ bin ];
+
+    if ( ++_windowIndex == WINDOW_SIZE ) {
+        _windowIndex = 0;
+    }
+
+    float percentile = getLoadPercentile();
+
+    // govern the quality tier (the sample counts only need to progress up to their hold durations)
+
+    int stepDownSamples = ( int ) ( STEP_DOWN_SECONDS * _sampleRate );
+    int stepUpSamples   = ( int ) ( STEP_UP_SECONDS * _sampleRate );
+
+    _tierSamples = std::min( _tierSamples + bufferSize, stepDownSamples );
+
+    if ( _governorEnabled && _windowCount >= MIN_WINDOW_SIZE ) {
+        if ( percentile > STEP_DOWN_LOAD ) {
+            _lowLoadSamples = 0;
+
+            if ( _tier < _amountOfTiers - 1 && _tierSamples >= stepDownSamples ) {
+                setTier( _tier + 1 );
+            }
+        } else if ( percentile < STEP_UP_LOAD ) {
+            _lowLoadSamples = std::min( _lowLoadSamples + bufferSize, stepUpSamples );
+
+            if ( _tier > 0 && _lowLoadSamples >= stepUpSamples ) {
+                setTier( _tier - 1 );
+            }
+        } else {
+            _lowLoadSamples = 0;
+        }
+    }
+
+    _publishedLoad.store( percentile, std::memory_order_relaxed );
+    _publishedNearMisses.store( _nearMisses, std::memory_order_relaxed );
+    _publishedOverruns.store( _overruns, std::memory_order_relaxed );
+}
+
+void DeadlineMonitor::setAmountOfTiers( int amount )
+{
+    _amountOfTiers = std::max( 1, amount );
+
+    if ( _tier >= _amountOfTiers ) {
+        setTier( _amountOfTiers - 1 );
+    }
+}
+
+int DeadlineMonitor::getAmountOfTiers()
+{
+    return _amountOfTiers;
+}
+
+void DeadlineMonitor::enableGovernor( bool enabled )
+{
+    _governorEnabled = enabled;
+
+    if ( !enabled ) {
+        setTier( 0 );
+    }
+}
+
+bool DeadlineMonitor::isGovernorEnabled()
+{
+    return _governorEnabled;
+}
+
+void DeadlineMonitor::reset()
+{
+    _nearMisses = 0;
+    _overruns   = 0;
+
+    setTier( 0 );
+
+    _publishedLoad.store( 0.f, std::memory_order_relaxed );
+    _publishedNearMisses.store( 0, std::memory_order_relaxed );
+    _publishedOverruns.store( 0, std::memory_order_relaxed );
+}
+
+DeadlineMonitor::State DeadlineMonitor::read()
+{
+    State state;
+
+    state.load       = _publishedLoad.load( std::memory_order_relaxed );
+    state.tier       = _publishedTier.load( std::memory_order_relaxed );
+    state.nearMisses = _publishedNearMisses.load( std::memory_order_relaxed );
+    state.overruns   = _publishedOverruns.load( std::memory_order_relaxed );
+
+    return state;
+}
+
+void DeadlineMonitor::setSampleRate( float sampleRate )
+{
+    _sampleRate = sampleRate;
+}
+
+/* private methods */
+
+float DeadlineMonitor::getLoadPercentile()
+{
+    int target     = ( int ) ceil( _windowCount * PERCENTILE );
+    int cumulative = 0;
+
+    for ( int bin = 0; bin < AMOUNT_OF_BINS; ++bin ) {
+        if (( cumulative += _histogram[ bin ]) >= target ) {
+            return ( bin + 1 ) * ( MAX_LOAD / AMOUNT_OF_BINS ); // upper bound of the bin
+        }
+    }
+    return MAX_LOAD;
+}
+
+void DeadlineMonitor::setTier( int tier )
+{
+    _tier = tier;
+    _publishedTier.store( tier, std::memory_order_relaxed );
+
+    // the loads measured at the previous tier no longer apply
+
+    _tierSamples    = 0;
+    _lowLoadSamples = 0;
+
+    clearWindow();
+}
+
+void DeadlineMonitor::clearWindow()
+{
+    for ( int i = 0; i < AMOUNT_OF_BINS; ++i ) {
+        _histogram[ i ] = 0;
+    }
+    _windowIndex = 0;
+    _windowCount = 0;
+}
+
+}
@@ -0,0 +1,152 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __DEADLINEMONITOR_H_INCLUDED__
+#define __DEADLINEMONITOR_H_INCLUDED__
+
+#include "global.h"
+#include <atomic>
+#include <chrono>
+
+using namespace Steinberg;
+
+namespace Igorski {
+
+/**
+ * Measures the wall-clock time spent processing each block against the real-time budget of that
+ * block (its duration at the current sample rate). The load (processing time relative to the
+ * budget) is tracked as a percentile over a moving window of blocks and blocks that come close to
+ * exceeding their budget are counted. When enabled, the monitor governs a quality tier : it steps
+ * down a tier while the load remains high and only steps back up after the load has remained low
+ * for a longer duration, so the tiers don't flip back and forth around the threshold.
+ * The state is published lock-free for metering from any other thread.
+ */
+class DeadlineMonitor
+{
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        static const int WINDOW_SIZE       = 128; // amount of blocks the load percentile is determined over
+        static const int MIN_WINDOW_SIZE   = 16;  // amount of blocks to measure before governing
+        static const int AMOUNT_OF_BINS    = 64;  // resolution of the load histogram
+        static constexpr float MAX_LOAD    = 2.f; // loads beyond are counted in the highest bin
+        static constexpr float PERCENTILE  = .95f;
+
+        static constexpr float NEAR_MISS_LOAD = .8f;  // blocks exceeding this share of their budget are near misses
+
+        // the governor steps down while the load percentile exceeds STEP_DOWN_LOAD and steps back up
+        // once the load percentile has remained below STEP_UP_LOAD for STEP_UP_SECONDS. After stepping
+        // down, the next tier is held for at least STEP_DOWN_SECONDS to measure its effect
+
+        static constexpr float STEP_DOWN_LOAD    = .5f;
+        static constexpr float STEP_UP_LOAD      = .25f;
+        static constexpr float STEP_DOWN_SECONDS = .5f;
+        static constexpr float STEP_UP_SECONDS   = 5.f;
+
+        struct State {
+            float  load       = 0.f; // load percentile (where 1 equals the entire budget)
+            int    tier       = 0;   // current quality tier (where 0 is full quality)
+            uint32 nearMisses = 0;   // amount of blocks exceeding NEAR_MISS_LOAD
+            uint32 overruns   = 0;   // amount of blocks exceeding their budget
+        };
+
+        DeadlineMonitor( float sampleRate );
+
+        static inline Clock::time_point now() {
+            return Clock::now();
+        }
+
+        // to be invoked by the audio thread once a block of given size, which
+        // started processing at given time, has been processed
+
+        void measure( Clock::time_point start, int bufferSize );
+
+        // the quality tier (in the 0 to getAmountOfTiers() - 1 range) the processor should run at
+
+        inline int getTier() {
+            return _tier;
+        }
+
+        // the amount of quality tiers the governor can step through (1 disables the governor)
+
+        void setAmountOfTiers( int amount );
+        int getAmountOfTiers();
+
+        // when disabled (e.g. when rendering offline, where there is no deadline to
+        // meet) the tier is reset and no near misses or overruns are counted
+
+        void enableGovernor( bool enabled );
+        bool isGovernorEnabled();
+
+        // clears the measurements and resets the tier to full quality
+
+        void reset();
+
+        // retrieve the last published state, can be invoked from any thread
+
+        State read();
+
+        void setSampleRate( float sampleRate );
+
+        // conversion of the load to a normalized (0 - 1 range) parameter value and back
+
+        static inline float loadToNormalized( float load ) {
+            return load >= MAX_LOAD ? 1.f : ( load <= 0.f ? 0.f : load / MAX_LOAD );
+        }
+
+        static inline float normalizedToLoad( float normalized ) {
+            return normalized * MAX_LOAD;
+        }
+
+    private:
+        float _sampleRate;
+        int   _amountOfTiers   = 1;
+        int   _tier            = 0;
+        bool  _governorEnabled = true;
+
+        // moving window of measured loads (as bin indices) and the histogram of their bins
+
+        int _window[ WINDOW_SIZE ];
+        int _histogram[ AMOUNT_OF_BINS ];
+        int _windowIndex = 0;
+        int _windowCount = 0;
+
+        int _tierSamples    = 0; // amount of samples processed at the current tier
+        int _lowLoadSamples = 0; // amount of samples processed while the load remained low
+
+        uint32 _nearMisses = 0;
+        uint32 _overruns   = 0;
+
+        // published state (the properties are independent and thus published individually)
+
+        std::atomic<float>  _publishedLoad{ 0.f };
+        std::atomic<int>    _publishedTier{ 0 };
+        std::atomic<uint32> _publishedNearMisses{ 0 };
+        std::atomic<uint32> _publishedOverruns{ 0 };
+
+        float getLoadPercentile();
+        void setTier( int tier );
+        void clearWindow();
+};
+}
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "envelopefollower.h"
+#include <algorithm>
+
+namespace Igorski {
+
+/* constructor */
+
+EnvelopeFollower::EnvelopeFollower( float sampleRate )
+{
+    setSampleRate( sampleRate );
+    setThreshold( -40.f );
+}
+
+/* setters */
+
+void EnvelopeFollower::setSampleRate( float sampleRate )
+{
+    _sampleRate = sampleRate;
+    recalculate();
+}
+
+void EnvelopeFollower::setAttack( float milliseconds )
+{
+    _attack = milliseconds;
+    recalculate();
+}
+
+void EnvelopeFollower::setRelease( float milliseconds )
+{
+    _release = milliseconds;
+    recalculate();
+}
+
+void EnvelopeFollower::setThreshold( float decibels )
+{
+    _threshold = powf( 10.f, decibels / 20.f );
+}
+
+void EnvelopeFollower::setDetectionMode( DetectionModes mode )
+{
+    _detectionMode = mode;
+}
+
+/* getters */
+
+float EnvelopeFollower::getLevel()
+{
+    return _level;
+}
+
+float EnvelopeFollower::getEnvelope()
+{
+    return _envelope;
+}
+
+/* private methods */
+
+void EnvelopeFollower::recalculate()
+{
+    // the gate level is updated once per chunk, the coefficients are scaled accordingly
+
+    double samplesPerMs = 0.001 * _sampleRate / CHUNK_SIZE;
+
+    _attackCoeff  = ( float ) ( 1.0 - exp( -1.0 / ( std::max( .1f, _attack )  * samplesPerMs )));
+    _releaseCoeff = ( float ) ( 1.0 - exp( -1.0 / ( std::max( 1.f, _release ) * samplesPerMs )));
+}
+
+}
@@ -0,0 +1,84 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __ENVELOPEFOLLOWER_H_INCLUDED__
+#define __ENVELOPEFOLLOWER_H_INCLUDED__
+
+#include "vectorops.h"
+#include <math.h>
+
+namespace Igorski {
+
+/**
+ * Derives a gate level from the envelope of a (sidechain) signal. The signal is
+ * detected in chunks (using the vectorized peak / sum of squares operations) and the
+ * gate opens while the detected level exceeds the threshold. The opening and closing
+ * of the gate is smoothed by the attack and release times and ramped over each chunk
+ */
+class EnvelopeFollower
+{
+    public:
+        static const int CHUNK_SIZE = 32; // amount of samples the level is detected over
+
+        enum DetectionModes {
+            PEAK,
+            RMS
+        };
+
+        EnvelopeFollower( float sampleRate );
+
+        // writes the gate level (in the 0 - 1 range) for each of the bufferSize samples of
+        // given signal into output, the level of all channels of the signal is followed
+
+        template <typename SampleType>
+        void process( SampleType** inBuffer, int numChannels, int bufferSize, float* output );
+
+        void setSampleRate( float sampleRate );
+        void setAttack( float milliseconds );
+        void setRelease( float milliseconds );
+        void setThreshold( float decibels );
+        void setDetectionMode( DetectionModes mode );
+
+        // the current gate level and last detected level (linear amplitude)
+
+        float getLevel();
+        float getEnvelope();
+
+    private:
+        float _sampleRate;
+        float _attack  = 10.f;  // in milliseconds
+        float _release = 100.f; // in milliseconds
+        float _threshold = 0.f; // linear amplitude
+        DetectionModes _detectionMode = DetectionModes::PEAK;
+
+        float _attackCoeff;
+        float _releaseCoeff;
+        float _level    = 0.f;
+        float _envelope = 0.f;
+
+        void recalculate();
+};
+}
+
+#include "envelopefollower.tcc"
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+
+namespace Igorski {
+
+template <typename SampleType>
+void EnvelopeFollower::process( SampleType** inBuffer, int numChannels, int bufferSize, float* output )
+{
+    for ( int offset = 0; offset < bufferSize; offset += CHUNK_SIZE )
+    {
+        int length = std::min(( int ) CHUNK_SIZE, bufferSize - offset );
+
+        // detect the level of the chunk across all channels
+
+        float peak     = 0.f;
+        double squares = 0.0;
+
+        for ( int c = 0; c < numChannels; ++c ) {
+            if ( _detectionMode == DetectionModes::PEAK ) {
+                peak = fmax( peak, VectorOps::peak<SampleType>( inBuffer[ c ] + offset, length ));
+            } else {
+                squares += VectorOps::sumOfSquares<SampleType>( inBuffer[ c ] + offset, length );
+            }
+        }
+        _envelope = _detectionMode == DetectionModes::PEAK ? peak : ( float ) sqrt( squares / ( numChannels * length ));
+
+        // move the gate level towards its target (open or closed) at the attack or release rate
+
+        float target = _envelope > _threshold ? 1.f : 0.f;
+        float coeff  = target > _level ? _attackCoeff : _releaseCoeff;
+        float next   = _level + ( target - _level ) * coeff;
+
+        // ramp towards the new level over the chunk
+
+        float increment = ( next - _level ) / length;
+        float level     = _level;
+
+        for ( int i = 0; i < length; ++i ) {
+            level += increment;
+            output[ offset + i ] = level;
+        }
+        _level = next;
+    }
+}
+
+}
@@ -0,0 +1,204 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "fdnreverb.h"
+#include <math.h>
+#include <string.h>
+
+namespace Igorski {
+
+FDNReverb::FDNReverb( int channel, float sampleRate, float* lineMemory ) {
+    _channel = channel;
+
+    // reserve the memory for all lines at once (unless provided), sized for the highest supported sample rate
+
+    _ownsLineMemory = lineMemory == nullptr;
+    _lineMemory     = _ownsLineMemory ? new float[ getLineMemorySize( channel ) ] : lineMemory;
+
+    // alternate the output polarities per channel to decorrelate the channels
+
+    for ( int i = 0; i < NUM_LINES; ++i ) {
+        _polarities[ i ]   = ((( i + channel ) % 2 ) == 0 ) ? 1.f : -1.f;
+        _filterStores[ i ] = 0.f;
+    }
+
+    setSampleRate( sampleRate );
+
+    setWet     ( INITIAL_WET );
+    setRoomSize( INITIAL_ROOM );
+    setDry     ( INITIAL_DRY );
+    setDamp    ( INITIAL_DAMP );
+    setWidth   ( INITIAL_WIDTH );
+    setMode    ( INITIAL_MODE );
+}
+
+FDNReverb::~FDNReverb() {
+    if ( _ownsLineMemory ) {
+        delete[] _lineMemory;
+    }
+}
+
+void FDNReverb::process( float* inBuffer, int bufferSize )
+{
+    for ( int i = 0; i < bufferSize; ++i ) {
+        inBuffer[ i ] = processSingle( inBuffer[ i ]);
+    }
+}
+
+void FDNReverb::mute()
+{
+    if ( getMode() >= FREEZE_MODE ) {
+        return;
+    }
+
+    for ( int i = 0; i < NUM_LINES; ++i ) {
+        memset( _lines[ i ], 0, _sizes[ i ] * sizeof( float ));
+        _filterStores[ i ] = 0.f;
+    }
+}
+
+float FDNReverb::getRoomSize()
+{
+    return ( _roomSize - OFFSET_ROOM ) / SCALE_ROOM;
+}
+
+void FDNReverb::setRoomSize( float value )
+{
+    _roomSize = ( value * SCALE_ROOM ) + OFFSET_ROOM;
+    update();
+}
+
+float FDNReverb::getDamp()
+{
+    return _damp / SCALE_DAMP;
+}
+
+void FDNReverb::setDamp( float value )
+{
+    _damp = value * SCALE_DAMP;
+    update();
+}
+
+float FDNReverb::getWet()
+{
+    return _wet / SCALE_WET;
+}
+
+void FDNReverb::setWet( float value )
+{
+    _wet = value * SCALE_WET;
+    update();
+}
+
+float FDNReverb::getDry()
+{
+    return _dry / SCALE_DRY;
+}
+
+void FDNReverb::setDry( float value )
+{
+    _dry = value * SCALE_DRY;
+}
+
+float FDNReverb::getWidth()
+{
+    return _width;
+}
+
+void FDNReverb::setWidth( float value )
+{
+    _width = value;
+    update();
+}
+
+float FDNReverb::getMode()
+{
+    return ( _mode >= FREEZE_MODE ) ? 1 : 0;
+}
+
+void FDNReverb::setMode( float value )
+{
+    _mode = value;
+    update();
+}
+
+void FDNReverb::toggleFreeze()
+{
+    setMode( getMode() == 1 ? INITIAL_MODE : FREEZE_MODE );
+}
+
+void FDNReverb::setSampleRate( float sampleRate )
+{
+    float* line = _lineMemory;
+
+    for ( int i = 0; i < NUM_LINES; ++i ) {
+        _lines[ i ]   = line;
+        _sizes[ i ]   = getLineSize( i, _channel, sampleRate );
+        _indices[ i ] = 0;
+
+        memset( _lines[ i ], 0, _sizes[ i ] * sizeof( float ));
+        _filterStores[ i ] = 0.f;
+
+        line += getLineSize( i, _channel, VST::MAX_SAMPLE_RATE );
+    }
+}
+
+/* private methods */
+
+void FDNReverb::update()
+{
+    // Recalculate internal values after parameter change
+
+    _wet1 = _wet * ( _width / 2 + 0.5f ) * OUTPUT_GAIN;
+
+    if ( _mode >= FREEZE_MODE ) {
+        // the Householder matrix is lossless, at unity feedback the tail sustains indefinitely
+        _feedback = 1;
+        _damp1    = 0;
+        _gain     = MUTED;
+    }
+    else {
+        _feedback = _roomSize;
+        _damp1    = _damp;
+        _gain     = FIXED_GAIN;
+    }
+    _damp2 = 1 - _damp1;
+}
+
+int FDNReverb::getLineMemorySize( int channel )
+{
+    int memorySize = 0;
+    for ( int i = 0; i < NUM_LINES; ++i ) {
+        memorySize += getLineSize( i, channel, VST::MAX_SAMPLE_RATE );
+    }
+    return memorySize;
+}
+
+int FDNReverb::getLineSize( int lineIndex, int channel, float sampleRate )
+{
+    // tunings are defined for 44.1 kHz, scale these to the given sample rate
+
+    float rate = std::min( sampleRate, VST::MAX_SAMPLE_RATE );
+    return ( int ) ((( float ) LINE_TUNINGS[ lineIndex ] / 44100.f ) * rate ) + ( channel * STEREO_SPREAD );
+}
+
+}
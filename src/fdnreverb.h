@@ -0,0 +1,170 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __FDNREVERB__H_INCLUDED__
+#define __FDNREVERB__H_INCLUDED__
+
+#include "global.h"
+#include "calc.h"
+
+using namespace Steinberg;
+
+namespace Igorski {
+
+/**
+ * Feedback delay network reverb, offered as an alternative to the
+ * Freeverb-style Reverb (and sharing its public interface). All lines are read
+ * in parallel and mixed back through a Householder matrix, which yields a dense tail
+ * for as many delay reads as the comb filter bank alone. The per-line operations
+ * are written over fixed size arrays so the compiler can vectorize them.
+ */
+class FDNReverb {
+
+    static const int NUM_LINES = 8;
+
+    static constexpr float MUTED         = 0;
+    static constexpr float FIXED_GAIN    = 0.015f;
+    static constexpr float SCALE_WET     = 1.f;
+    static constexpr float SCALE_DRY     = 1.f;
+    static constexpr float SCALE_DAMP    = 0.4f;
+    static constexpr float SCALE_ROOM    = 0.28f;
+    static constexpr float OFFSET_ROOM   = 0.7f;
+    static constexpr float INITIAL_ROOM  = 0.5f;
+    static constexpr float INITIAL_DAMP  = 0.5f;
+    static constexpr float INITIAL_WET   = 1 / SCALE_WET;
+    static constexpr float INITIAL_DRY   = 0.5f;
+    static constexpr float INITIAL_WIDTH = 1;
+    static constexpr float INITIAL_MODE  = 0;
+    static constexpr float FREEZE_MODE   = 0.5f;
+    static constexpr float HOUSEHOLDER   = 2.f / NUM_LINES;
+    static constexpr float OUTPUT_GAIN   = 6.5f; // matches the loudness of the Freeverb-style Reverb
+    static const int STEREO_SPREAD       = 23;
+
+    // line lengths (tuned to 44.1 kHz), mutually prime to avoid coinciding echoes
+
+    static constexpr int LINE_TUNINGS[ NUM_LINES ] = { 1123, 1277, 1361, 1493, 1609, 1721, 1847, 1993 };
+
+    public:
+        // channel determines the line length offset and output polarities, giving
+        // each channel a differently colored tail for a decorrelated stereo image
+
+        // the line memory can optionally be provided (for instance when allocated within an Arena)
+        // it must hold getLineMemorySize( channel ) samples and remains owned by the caller
+
+        FDNReverb( int channel, float sampleRate, float* lineMemory = nullptr );
+        ~FDNReverb();
+
+        static int getLineMemorySize( int channel );
+
+        // apply effect to incoming sampleBuffer contents
+
+        void process( float* inBuffer, int bufferSize );
+
+        inline float processSingle( float inputSample ) {
+
+            float processedSample = 0;
+            inputSample *= _gain;
+
+            // read the line outputs and apply the damping lowpass
+
+            for ( int i = 0; i < NUM_LINES; ++i ) {
+                _outputs[ i ] = _lines[ i ][ _indices[ i ]];
+            }
+
+            float sum = 0;
+            for ( int i = 0; i < NUM_LINES; ++i ) {
+                _filterStores[ i ] = ( _outputs[ i ] * _damp2 ) + ( _filterStores[ i ] * _damp1 );
+                sum += _filterStores[ i ];
+                processedSample += _filterStores[ i ] * _polarities[ i ];
+            }
+
+            // Householder feedback matrix (I - 2/N) reduces to subtracting the scaled sum
+
+            sum *= HOUSEHOLDER;
+            for ( int i = 0; i < NUM_LINES; ++i ) {
+                _feedbacks[ i ] = inputSample + ( _filterStores[ i ] - sum ) * _feedback;
+            }
+
+            // write the feedback back into the lines
+
+            for ( int i = 0; i < NUM_LINES; ++i ) {
+                _lines[ i ][ _indices[ i ]] = _feedbacks[ i ];
+                if ( ++_indices[ i ] >= _sizes[ i ]) {
+                    _indices[ i ] = 0;
+                }
+            }
+
+            // wet mix (e.g. the reverberated signal) and dry mix (e.g. mix in the input signal)
+            return ( processedSample * _wet1 ) + ( inputSample * _dry );
+        }
+
+        void mute();
+        void setRoomSize( float value );
+        float getRoomSize();
+        void setDamp( float value );
+        float getDamp();
+        void setWet( float value );
+        float getWet();
+        void setDry( float value );
+        float getDry();
+        float getWidth();
+        void setWidth( float value );
+        float getMode();
+        void setMode( float value );
+        void toggleFreeze();
+
+        // retunes the delay lines to given sample rate. this does not allocate
+        // (line memory is reserved for VST::MAX_SAMPLE_RATE upon construction)
+        // but does flush the reverb tail, so invoke this outside of the audio thread
+
+        void setSampleRate( float sampleRate );
+
+    private:
+        int _channel;
+
+        void update();
+        static int getLineSize( int lineIndex, int channel, float sampleRate );
+
+        float _gain;
+        float _roomSize, _feedback;
+        float _damp, _damp1, _damp2;
+        float _wet, _wet1;
+        float _dry;
+        float _width;
+        float _mode;
+
+        // per line state, kept as arrays so the per-line operations vectorize
+
+        alignas( 16 ) float _outputs[ NUM_LINES ];
+        alignas( 16 ) float _filterStores[ NUM_LINES ];
+        alignas( 16 ) float _feedbacks[ NUM_LINES ];
+        alignas( 16 ) float _polarities[ NUM_LINES ];
+        int    _indices[ NUM_LINES ];
+        int    _sizes[ NUM_LINES ];
+        float* _lines[ NUM_LINES ];
+
+        float* _lineMemory = nullptr; // single block holding all lines back to back
+        bool   _ownsLineMemory = false;
+};
+}
+
+#endif
@@ -0,0 +1,151 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "fft.h"
+#include "global.h"
+#include <math.h>
+#include <string.h>
+
+namespace Igorski {
+
+/* constructor / destructor */
+
+FFT::FFT( int aSize )
+{
+    size      = aSize;
+    _log2Size = 0;
+    while (( 1 << _log2Size ) < size ) {
+        ++_log2Size;
+    }
+
+    _bitReversed = new int[ size ];
+    for ( int i = 0; i < size; ++i ) {
+        int reversed = 0;
+        for ( int b = 0; b < _log2Size; ++b ) {
+            reversed |= (( i >> b ) & 1 ) << ( _log2Size - 1 - b );
+        }
+        _bitReversed[ i ] = reversed;
+    }
+
+    int half  = size / 2;
+    _cosTable = new float[ half ];
+    _sinTable = new float[ half ];
+
+    for ( int i = 0; i < half; ++i ) {
+        double phase = -2.0 * ( double ) VST::PI * ( double ) i / ( double ) size;
+        _cosTable[ i ] = ( float ) cos( phase );
+        _sinTable[ i ] = ( float ) sin( phase );
+    }
+}
+
+FFT::~FFT()
+{
+    delete[] _bitReversed;
+    delete[] _cosTable;
+    delete[] _sinTable;
+}
+
+/* public methods */
+
+void FFT::forward( float* real, float* imag )
+{
+    transform( real, imag, false );
+}
+
+void FFT::inverse( float* real, float* imag )
+{
+    transform( real, imag, true );
+
+    float scale = 1.f / ( float ) size;
+    for ( int i = 0; i < size; ++i ) {
+        real[ i ] *= scale;
+        imag[ i ] *= scale;
+    }
+}
+
+void FFT::forwardReal( const float* input, float* outReal, float* outImag )
+{
+    memcpy( outReal, input, size * sizeof( float ));
+    memset( outImag, 0, size * sizeof( float ));
+
+    transform( outReal, outImag, false );
+}
+
+void FFT::inverseReal( float* real, float* imag, float* output )
+{
+    // restore the upper half of the spectrum from its conjugate symmetry
+
+    int half = size / 2;
+    for ( int i = 1; i < half; ++i ) {
+        real[ size - i ] =  real[ i ];
+        imag[ size - i ] = -imag[ i ];
+    }
+    inverse( real, imag );
+
+    if ( output != real ) {
+        memcpy( output, real, size * sizeof( float ));
+    }
+}
+
+/* private methods */
+
+void FFT::transform( float* real, float* imag, bool inverse )
+{
+    // reorder input into bit reversed order
+
+    for ( int i = 0; i < size; ++i ) {
+        int j = _bitReversed[ i ];
+        if ( j > i ) {
+            float tmp = real[ i ]; real[ i ] = real[ j ]; real[ j ] = tmp;
+            tmp       = imag[ i ]; imag[ i ] = imag[ j ]; imag[ j ] = tmp;
+        }
+    }
+
+    // butterflies, the inverse transform uses the conjugated twiddle factors
+
+    float direction = inverse ? -1.f : 1.f;
+
+    for ( int length = 2; length <= size; length <<= 1 ) {
+        int half   = length >> 1;
+        int stride = size / length;
+
+        for ( int start = 0; start < size; start += length ) {
+            for ( int k = 0; k < half; ++k ) {
+                float wr = _cosTable[ k * stride ];
+                float wi = _sinTable[ k * stride ] * direction;
+
+                int even = start + k;
+                int odd  = even + half;
+
+                float tr = real[ odd ] * wr - imag[ odd ] * wi;
+                float ti = real[ odd ] * wi + imag[ odd ] * wr;
+
+                real[ odd ]  = real[ even ] - tr;
+                imag[ odd ]  = imag[ even ] - ti;
+                real[ even ] += tr;
+                imag[ even ] += ti;
+            }
+        }
+    }
+}
+
+}
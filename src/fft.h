@@ -0,0 +1,101 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __FFT_H_INCLUDED__
+#define __FFT_H_INCLUDED__
+
+#include "snd.h"
+#include "vectorops.h"
+
+#ifdef USE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
+
+namespace Igorski {
+
+/**
+ * Iterative radix-2 Fast Fourier Transform operating in place on split
+ * (separate real and imaginary) arrays. The twiddle factors and bit reversal
+ * permutation are calculated once upon construction, transforms do not allocate
+ */
+class FFT
+{
+    public:
+        FFT( int size ); // size must be a power of two
+        ~FFT();
+
+        int size;
+
+        void forward( float* real, float* imag );
+        void inverse( float* real, float* imag ); // scaled by 1 / size
+
+        // transforms size real valued samples into the size / 2 + 1 unique bins of their
+        // spectrum. outReal and outImag must hold size values as they double as work buffers
+
+        void forwardReal( const float* input, float* outReal, float* outImag );
+
+        // the inverse of forwardReal(), takes the size / 2 + 1 unique bins of a real valued
+        // signal and writes its size samples into output. real and imag are used as work buffers
+
+        void inverseReal( float* real, float* imag, float* output );
+
+        /**
+         * accumulates the product of two spectra into the given accumulator (e.g. a multiplication
+         * in the frequency domain equals a convolution in the time domain). This is the hot
+         * path of partitioned convolution, hence the explicit vectorization
+         */
+        static inline void multiplyAccumulate( const float* aReal, const float* aImag,
+                                               const float* bReal, const float* bImag,
+                                               float* accReal, float* accImag, int length )
+        {
+            int i = 0;
+#ifdef USE_SSE_INTRINSICS
+            for ( ; !VectorOps::forceScalar && i + 4 <= length; i += 4 ) {
+                __m128 ar = _mm_loadu_ps( aReal + i );
+                __m128 ai = _mm_loadu_ps( aImag + i );
+                __m128 br = _mm_loadu_ps( bReal + i );
+                __m128 bi = _mm_loadu_ps( bImag + i );
+
+                __m128 re = _mm_sub_ps( _mm_mul_ps( ar, br ), _mm_mul_ps( ai, bi ));
+                __m128 im = _mm_add_ps( _mm_mul_ps( ar, bi ), _mm_mul_ps( ai, br ));
+
+                _mm_storeu_ps( accReal + i, _mm_add_ps( _mm_loadu_ps( accReal + i ), re ));
+                _mm_storeu_ps( accImag + i, _mm_add_ps( _mm_loadu_ps( accImag + i ), im ));
+            }
+#endif
+            for ( ; i < length; ++i ) {
+                accReal[ i ] += aReal[ i ] * bReal[ i ] - aImag[ i ] * bImag[ i ];
+                accImag[ i ] += aReal[ i ] * bImag[ i ] + aImag[ i ] * bReal[ i ];
+            }
+        }
+
+    private:
+        int    _log2Size;
+        int*   _bitReversed;
+        float* _cosTable;
+        float* _sinTable;
+
+        void transform( float* real, float* imag, bool inverse );
+};
+}
+
+#endif
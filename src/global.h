@@ -19,7 +19,12 @@ namespace VST {
     static const FUID PluginWithSideChainProcessorUID( 0x955D4A80, 0x85CF461F, 0xAAD2543F, 0x5F242E0B );
     static const FUID PluginControllerUID( 0x85CF461F, 0xAAD2543F, 0x5F242E0B, 0x955D4A80 );
 
-    extern float SAMPLE_RATE; // set upon initialization, see vst.cpp
+    extern float SAMPLE_RATE; // set upon initialization, see vst.cpp (the DSP uses the per instance ProcessingContext instead)
+
+    // the highest sample rate for which delay line memory is reserved up front
+    // (higher rates are supported, though their tunings are capped at this rate)
+
+    static const float MAX_SAMPLE_RATE = 192000.f;
 
     static const float PI     = 3.141592653589793f;
     static const float TWO_PI = PI * 2.f;
@@ -32,6 +37,12 @@ namespace VST {
 
     static const int COMB_TUNINGS[ NUM_COMBS ] = { 1116, 1188, 1277, 1356, 1422, 1491, 1557, 1617 };
     static const int ALLPASS_TUNINGS[ NUM_ALLPASSES ] = { 556, 441, 341, 225 };
+
+    // input diffusers of the (optional) dense reverb mode
+
+    static const int NUM_DIFFUSERS = 4;
+
+    static const int DIFFUSER_TUNINGS[ NUM_DIFFUSERS ] = { 211, 157, 563, 409 };
 }
 }
 
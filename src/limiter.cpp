@@ -25,7 +25,9 @@
  */
 #include "limiter.h"
 #include "global.h"
+#include <algorithm>
 #include <math.h>
+#include <string.h>
 
 // constructors / destructor
 
@@ -41,7 +43,7 @@ Limiter::Limiter( float attackMs, float releaseMs, float thresholdDb )
 
 Limiter::~Limiter()
 {
-    // nowt...
+    releaseLookahead();
 }
 
 /* public methods */
@@ -66,7 +68,94 @@ void Limiter::setThreshold( float thresholdDb )
 
 float Limiter::getLinearGR()
 {
-    return gain > 1.f ? 1.f / gain : 1.f;
+    return std::min( 1.f, lowestGain );
+}
+
+void Limiter::resetGainReduction()
+{
+    lowestGain = 1.f;
+}
+
+void Limiter::enableLookahead( int amountOfChannels, float lookaheadMs, float ceilingDb, bool truePeak,
+                               float* memory, uint32_t* positions )
+{
+    releaseLookahead();
+
+    _memory             = memory;
+    _windowPositions    = positions;
+    _ownsMemory         = memory == nullptr;
+    _lookahead          = true;
+    _lookaheadAllocated = true;
+    _truePeak         = truePeak;
+    _amountOfChannels = amountOfChannels;
+    _lookaheadMs      = lookaheadMs;
+    _ceiling          = ( float ) pow( 10.0, ceilingDb / 20.0 );
+
+    allocateLookahead( _sampleRate );
+}
+
+void Limiter::disableLookahead()
+{
+    _lookahead          = false;
+    _lookaheadAllocated = false;
+
+    releaseLookahead();
+    _windowSize = 0;
+    _delaySize  = 0;
+}
+
+void Limiter::setLookahead( bool enabled, bool truePeak )
+{
+    enabled = enabled && _lookaheadAllocated;
+
+    // a lookahead that is (re)enabled starts without history
+
+    if ( enabled && !_lookahead ) {
+        clearLookahead();
+    }
+    _lookahead = enabled;
+    _truePeak  = truePeak;
+}
+
+void Limiter::setSampleRate( float sampleRate )
+{
+    _sampleRate = sampleRate;
+    recalculate();
+
+    if ( _lookaheadAllocated ) {
+        allocateLookahead( sampleRate );
+    }
+}
+
+bool Limiter::hasLookahead()
+{
+    return _lookahead;
+}
+
+int Limiter::getLatency()
+{
+    return _lookahead ? _delaySize : 0;
+}
+
+int Limiter::getLookaheadMemorySize( int amountOfChannels, float lookaheadMs )
+{
+    int delaySize  = calculateLatency( lookaheadMs, Igorski::VST::MAX_SAMPLE_RATE );
+    int windowSize = delaySize - DETECTOR_DELAY + 1;
+
+    return amountOfChannels * ( delaySize + TRUE_PEAK_HISTORY ) + windowSize * 2;
+}
+
+int Limiter::getLookaheadPositionsSize( float lookaheadMs )
+{
+    return calculateLatency( lookaheadMs, Igorski::VST::MAX_SAMPLE_RATE ) - DETECTOR_DELAY + 1;
+}
+
+int Limiter::calculateLatency( float lookaheadMs, float sampleRate )
+{
+    sampleRate = std::min( sampleRate, Igorski::VST::MAX_SAMPLE_RATE );
+
+    int windowSize = std::max( 1, ( int ) ( lookaheadMs * 0.001f * sampleRate ));
+    return windowSize + DETECTOR_DELAY - 1;
 }
 
 /* protected methods */
@@ -97,4 +186,64 @@ void Limiter::recalculate()
     trim = ( float )( pow( 10.0, ( 2.0 * pTrim) - 1.f ));
     att  = ( float )  pow( 10.0, -2.0 * pAttack );
     rel  = ( float )  pow( 10.0, -2.0 - ( 3.0 * pRelease ));
+
+    // the lookahead mode has no attack stage (gain is reduced over the lookahead
+    // window) and treats the release as a time constant in milliseconds
+
+    _releaseCoeff = ( float ) ( 1.0 - exp( -1.0 / ( std::max( 1.f, pRelease ) * 0.001 * _sampleRate )));
+}
+
+void Limiter::allocateLookahead( float sampleRate )
+{
+    _delaySize  = calculateLatency( _lookaheadMs, sampleRate );
+    _windowSize = _delaySize - DETECTOR_DELAY + 1;
+
+    int delayLineSize = _amountOfChannels * _delaySize;
+    int historySize   = _amountOfChannels * TRUE_PEAK_HISTORY;
+
+    // provided memory is reserved for the highest supported sample rate, owned memory is sized to fit
+
+    if ( _ownsMemory ) {
+        delete[] _memory;
+        delete[] _windowPositions;
+        _memory          = new float[ delayLineSize + historySize + _windowSize * 2 ];
+        _windowPositions = new uint32_t[ _windowSize ];
+    }
+
+    _delayLines   = _memory;
+    _peakHistory  = _delayLines + delayLineSize;
+    _windowValues = _peakHistory + historySize;
+    _gainHistory  = _windowValues + _windowSize;
+
+    recalculate();
+    clearLookahead();
+}
+
+void Limiter::releaseLookahead()
+{
+    if ( _ownsMemory ) {
+        delete[] _memory;
+        delete[] _windowPositions;
+    }
+    _memory          = nullptr;
+    _windowPositions = nullptr;
+    _ownsMemory      = true;
+}
+
+void Limiter::clearLookahead()
+{
+    memset( _delayLines,  0, _amountOfChannels * _delaySize * sizeof( float ));
+    memset( _peakHistory, 0, _amountOfChannels * TRUE_PEAK_HISTORY * sizeof( float ));
+
+    for ( int i = 0; i < _windowSize; ++i ) {
+        _gainHistory[ i ] = 1.f;
+    }
+    _gainSum      = _windowSize;
+    _releasedGain = 1.f;
+
+    _delayIndex  = 0;
+    _gainIndex   = 0;
+    _windowHead  = 0;
+    _windowCount = 0;
+    _position    = 0;
 }
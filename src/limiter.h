@@ -27,6 +27,9 @@
 #define __LIMITER_H_INCLUDED__
 
 #include "audiobuffer.h"
+#include "vectorops.h"
+#include <algorithm>
+#include <cstdint>
 #include <math.h>
 
 class Limiter
@@ -36,19 +39,69 @@ class Limiter
         Limiter( float attackMs, float releaseMs, float thresholdDb );
         ~Limiter();
 
+        // limits bufferSize samples of each channel, starting at given offset within the channel buffers
+
         template <typename SampleType>
-        void process( SampleType** outputBuffer, int bufferSize, int numOutChannels );
+        void process( SampleType** outputBuffer, int bufferSize, int numOutChannels, int offset = 0 );
 
         void setAttack( float attackMs );
         void setRelease( float releaseMs );
         void setThreshold( float thresholdDb );
 
+        // the lowest gain applied since the last resetGainReduction() call (1 when no reduction took place),
+        // resetting once per block allows the block to be processed in multiple process() calls
+
         float getLinearGR();
+        void resetGainReduction();
+
+        // lookahead mode delays the signal so gain reduction can be applied ahead of the peaks,
+        // keeping the output below the ceiling without the overshoot of the classic mode. When
+        // truePeak is enabled, inter-sample peaks are estimated at four times the sample rate
+        // NOTE : these allocate, invoke outside of the audio thread. The lookahead memory can
+        // optionally be provided (for instance when allocated within an Arena) : memory must hold
+        // getLookaheadMemorySize() values and positions getLookaheadPositionsSize() values. Both
+        // are either provided or omitted and remain owned by the caller
+
+        void enableLookahead( int amountOfChannels, float lookaheadMs, float ceilingDb, bool truePeak,
+                              float* memory = nullptr, uint32_t* positions = nullptr );
+        void disableLookahead();
+
+        // the amount of values the lookahead memory occupies at the highest supported sample rate
+
+        static int getLookaheadMemorySize( int amountOfChannels, float lookaheadMs );
+        static int getLookaheadPositionsSize( float lookaheadMs );
+
+        // switches between the classic and lookahead mode once the latter has been allocated by
+        // enableLookahead(), this does not allocate and can thus be invoked on the audio thread
+
+        void setLookahead( bool enabled, bool truePeak );
+
+        // the rate (44.1 kHz by default) the time constants are calculated for
+
+        void setSampleRate( float sampleRate );
+        bool hasLookahead();
+
+        // the latency (in samples) introduced by the lookahead mode
+
+        int getLatency();
+
+        // the latency (in samples) the lookahead mode introduces for given lookahead at given sample rate
+        // (rates above VST::MAX_SAMPLE_RATE use the window of the maximum rate)
+
+        static int calculateLatency( float lookaheadMs, float sampleRate );
 
     protected:
         void init( float attackMs, float releaseMs, float thresholdDb );
         void recalculate();
 
+        template <typename SampleType>
+        void processLookahead( SampleType** outputBuffer, int bufferSize, int numOutChannels, int offset );
+
+        // calculates the gain for each detected level (the per-sample gain recursion of the classic mode)
+
+        template <bool softKnee>
+        void calculateGains( const float* levels, float* gains, int length, float detectorScale );
+
         float pTresh;   // in dB, -20 - 20
         float pTrim;
         float pAttack;  // in microseconds
@@ -56,6 +109,73 @@ class Limiter
         float pKnee;
 
         float thresh, gain, att, rel, trim;
+        float lowestGain = 1.f;
+
+        static const int CHUNK_SIZE = 64; // amount of gain values calculated at a time
+
+        // lookahead mode
+
+        static const int TRUE_PEAK_HISTORY = 5;  // input samples needed to estimate inter-sample peaks
+        static const int DETECTOR_DELAY    = 2;  // the detector runs this many samples behind the input
+        bool  _lookahead = false;
+        bool  _truePeak  = false;
+        bool  _lookaheadAllocated = false;
+        bool  _ownsMemory = true;
+        int   _amountOfChannels = 0;
+        float _lookaheadMs;
+        float _sampleRate = 44100.f;
+        float _ceiling;         // linear
+        float _releaseCoeff;
+        int   _windowSize = 0;  // lookahead in samples
+        int   _delaySize  = 0;  // window size plus detector delay
+
+        float* _memory = nullptr;   // single block of memory holding all float buffers below
+        float* _delayLines;         // per channel delay of the output signal
+        float* _peakHistory;        // per channel history of the input signal, for peak detection
+        float* _windowValues;       // monotonic deque of the peaks within the lookahead window
+        float* _gainHistory;        // last window size amount of gains, for smoothing
+        uint32_t* _windowPositions = nullptr; // positions of the deque peaks, kept apart from the float block
+        double _gainSum;
+
+        int _delayIndex;
+        int _gainIndex;
+        int _windowHead;
+        int _windowCount;
+        uint32_t _position;
+        float _releasedGain;
+
+        void allocateLookahead( float sampleRate );
+        void releaseLookahead();
+        void clearLookahead();
+
+        // estimates the peak of the input sample at DETECTOR_DELAY samples in the past using
+        // the history of the channel (ordered from oldest to newest sample)
+
+        inline float detectPeak( const float* history ) {
+            float peak = fabs( history[ 2 ]);
+
+            if ( !_truePeak ) {
+                return peak;
+            }
+
+            // Catmull-Rom interpolation at quarter positions of the segments surrounding the sample
+
+            for ( int segment = 0; segment < 2; ++segment ) {
+                const float* p = history + segment;
+                for ( int phase = 0; phase < 3; ++phase ) {
+                    const float* w = TRUE_PEAK_WEIGHTS[ phase ];
+                    float value = w[ 0 ] * p[ 0 ] + w[ 1 ] * p[ 1 ] + w[ 2 ] * p[ 2 ] + w[ 3 ] * p[ 3 ];
+                    peak = fmax( peak, fabs( value ));
+                }
+            }
+            return peak;
+        }
+
+        static constexpr float TRUE_PEAK_WEIGHTS[ 3 ][ 4 ] = {
+            { -0.0703125f, 0.8671875f, 0.2265625f, -0.0234375f }, // t = .25
+            { -0.0625f,    0.5625f,    0.5625f,    -0.0625f    }, // t = .5
+            { -0.0234375f, 0.2265625f, 0.8671875f, -0.0703125f }  // t = .75
+        };
 };
 
 #include "limiter.tcc"
@@ -24,7 +24,7 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 template <typename SampleType>
-void Limiter::process( SampleType** outputBuffer, int bufferSize, int numOutChannels )
+void Limiter::process( SampleType** outputBuffer, int bufferSize, int numOutChannels, int offset )
 {
 //    if ( gain > 0.9999f && outputBuffer->isSilent )
 //    {
@@ -32,29 +32,61 @@ void Limiter::process( SampleType** outputBuffer, int bufferSize, int numOutChan
 //        return;
 //    }
 
-    SampleType g, at, re, tr, th, lev, ol, or_;
+    if ( _lookahead ) {
+        processLookahead<SampleType>( outputBuffer, bufferSize, numOutChannels, offset );
+        return;
+    }
+
+    // all channels are linked : the detector follows the loudest channel. The original stereo detector
+    // responded to the level of the sum of both channels, scaling the maximum by the channel count
+    // (for up to two channels) keeps the threshold equivalent for correlated signals
+
+    float detectorScale = ( float ) std::min( numOutChannels, 2 );
+    bool softKnee       = pKnee > 0.5;
+
+    float levels[ CHUNK_SIZE ];
+    float gains [ CHUNK_SIZE ];
+
+    for ( int chunk = 0; chunk < bufferSize; chunk += CHUNK_SIZE ) {
+        int chunkSize = std::min(( int ) CHUNK_SIZE, bufferSize - chunk );
+        int start     = offset + chunk;
+
+        // 1. detector pass over all channels
 
-    th = thresh;
-    g = gain;
-    at = att;
-    re = rel;
-    tr = trim;
+        std::fill( levels, levels + chunkSize, 0.f );
 
-    bool hasRight = ( numOutChannels > 1 );
+        for ( int c = 0; c < numOutChannels; ++c ) {
+            Igorski::VectorOps::maxAbs<SampleType>( outputBuffer[ c ] + start, levels, chunkSize );
+        }
+
+        // 2. gain calculation, the knee is a setting and thus decided per block
 
-    SampleType* leftBuffer  = outputBuffer[ 0 ];
-    SampleType* rightBuffer = hasRight ? outputBuffer[ 1 ] : 0;
+        if ( softKnee ) {
+            calculateGains<true>( levels, gains, chunkSize, detectorScale );
+        } else {
+            calculateGains<false>( levels, gains, chunkSize, detectorScale );
+        }
 
-    if ( pKnee > 0.5 )
-    {
-        // soft knee
+        // 3. gain apply pass
 
-        for ( int i = 0; i < bufferSize; ++i ) {
+        for ( int c = 0; c < numOutChannels; ++c ) {
+            Igorski::VectorOps::multiply<SampleType>( outputBuffer[ c ] + start, gains, trim, chunkSize );
+        }
+    }
+}
 
-            ol  = leftBuffer[ i ];
-            or_ = hasRight ? rightBuffer[ i ] : 0;
+template <bool softKnee>
+void Limiter::calculateGains( const float* levels, float* gains, int length, float detectorScale )
+{
+    float g  = gain;
+    float th = thresh;
+    float at = att;
+    float re = rel;
+    float lev;
 
-            lev = ( SampleType ) ( 1.f / ( 1.f + th * fabs( ol + or_ )));
+    for ( int i = 0; i < length; ++i ) {
+        if ( softKnee ) {
+            lev = 1.f / ( 1.f + th * levels[ i ] * detectorScale );
 
             if ( g > lev ) {
                 g = g - at * ( g - lev );
@@ -62,35 +94,124 @@ void Limiter::process( SampleType** outputBuffer, int bufferSize, int numOutChan
             else {
                 g = g + re * ( lev - g );
             }
-
-            leftBuffer[ i ] = ( ol * tr * g );
-
-            if ( hasRight )
-                rightBuffer[ i ] = ( or_ * tr * g );
         }
-    }
-    else
-    {
-        for ( int i = 0; i < bufferSize; ++i ) {
-
-            ol  = leftBuffer[ i ];
-            or_ = hasRight ? rightBuffer[ i ] : 0;
-
-            lev = ( SampleType ) ( 0.5 * g * fabs( ol + or_ ));
+        else {
+            lev = 0.5f * g * levels[ i ] * detectorScale;
 
             if ( lev > th ) {
                 g = g - ( at * ( lev - th ));
             }
             else {
                 // below threshold
-                g = g + ( SampleType )( re * ( 1.f - g ));
+                g = g + ( re * ( 1.f - g ));
+            }
+        }
+        gains[ i ] = g;
+        lowestGain = std::min( lowestGain, g );
+    }
+    gain = g;
+}
+
+template <typename SampleType>
+void Limiter::processLookahead( SampleType** outputBuffer, int bufferSize, int numOutChannels, int offset )
+{
+    int channels = std::min( numOutChannels, _amountOfChannels );
+    float tr     = trim;
+    float gains[ CHUNK_SIZE ];
+
+    for ( int chunk = 0; chunk < bufferSize; chunk += CHUNK_SIZE ) {
+        int chunkSize = std::min(( int ) CHUNK_SIZE, bufferSize - chunk );
+        int start     = offset + chunk;
+
+        // 1. calculate the gain for each sample of the chunk from the (linked) peak of all channels
+
+        for ( int i = 0; i < chunkSize; ++i ) {
+            float peak = 0.f;
+
+            for ( int c = 0; c < channels; ++c ) {
+                float* history = _peakHistory + c * TRUE_PEAK_HISTORY;
+                for ( int h = 0; h < TRUE_PEAK_HISTORY - 1; ++h ) {
+                    history[ h ] = history[ h + 1 ];
+                }
+                history[ TRUE_PEAK_HISTORY - 1 ] = ( float ) outputBuffer[ c ][ start + i ] * tr;
+                peak = fmax( peak, detectPeak( history ));
+            }
+
+            // maximum peak within the lookahead window, kept in a monotonic deque where each
+            // peak is dropped once it leaves the window or a louder peak is detected
+
+            if ( _windowCount > 0 && ( _position - _windowPositions[ _windowHead ]) >= ( uint32_t ) _windowSize ) {
+                if ( ++_windowHead == _windowSize ) {
+                    _windowHead = 0;
+                }
+                --_windowCount;
+            }
+
+            while ( _windowCount > 0 ) {
+                int back = ( _windowHead + _windowCount - 1 ) % _windowSize;
+                if ( _windowValues[ back ] > peak ) {
+                    break;
+                }
+                --_windowCount;
+            }
+
+            int tail = ( _windowHead + _windowCount ) % _windowSize;
+            _windowValues   [ tail ] = peak;
+            _windowPositions[ tail ] = _position++;
+            ++_windowCount;
+
+            float maxPeak = _windowValues[ _windowHead ];
+            float target  = ( maxPeak > _ceiling ) ? _ceiling / maxPeak : 1.f;
+
+            // gain reduction is immediate, gain recovery follows the release time
+
+            if ( target < _releasedGain ) {
+                _releasedGain = target;
+            } else {
+                _releasedGain += _releaseCoeff * ( target - _releasedGain );
             }
 
-            leftBuffer[ i ] = ( ol * tr * g );
+            // averaging the gain over the window turns each reduction into a ramp
+            // that completes exactly when the peak leaves the delay line
 
-            if ( hasRight )
-                rightBuffer[ i ] = ( or_ * tr * g );
+            _gainSum += _releasedGain - _gainHistory[ _gainIndex ];
+            _gainHistory[ _gainIndex ] = _releasedGain;
+
+            if ( ++_gainIndex == _windowSize ) {
+                _gainIndex = 0;
+            }
+            gains[ i ] = ( float ) ( _gainSum / _windowSize );
+            lowestGain = std::min( lowestGain, gains[ i ]);
+        }
+
+        // 2. apply the gains to the delayed signal, the delay lines are traversed
+        // in contiguous spans (split where they wrap) so this pass vectorizes
+
+        int delayIndex = _delayIndex;
+
+        for ( int c = 0; c < channels; ++c ) {
+            SampleType* buffer = outputBuffer[ c ] + start;
+            float* delayLine   = _delayLines + c * _delaySize;
+
+            delayIndex = _delayIndex;
+
+            for ( int done = 0; done < chunkSize; ) {
+                int span    = std::min( chunkSize - done, _delaySize - delayIndex );
+                float* line = delayLine + delayIndex;
+
+                for ( int i = 0; i < span; ++i ) {
+                    float delayed = line[ i ];
+                    line[ i ] = ( float ) buffer[ done + i ] * tr;
+                    buffer[ done + i ] = ( SampleType ) ( delayed * gains[ done + i ]);
+                }
+                done += span;
+
+                if (( delayIndex += span ) == _delaySize ) {
+                    delayIndex = 0;
+                }
+            }
         }
+        _delayIndex = ( _delayIndex + chunkSize ) % _delaySize;
+        gain = gains[ chunkSize - 1 ];
     }
-    gain = g;
 }
@@ -0,0 +1,106 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "meter.h"
+#include <algorithm>
+
+namespace Igorski {
+
+/* constructor */
+
+Meter::Meter( float sampleRate )
+{
+    setSampleRate( sampleRate );
+}
+
+/* public methods */
+
+void Meter::measureGainReduction( float linearGain )
+{
+    _gainReduction = std::min( _gainReduction, linearGain );
+}
+
+void Meter::update( int bufferSize )
+{
+    _windowProgress += bufferSize;
+
+    if ( _windowProgress < _windowSize ) {
+        return;
+    }
+    publish();
+
+    _windowProgress = 0;
+    _inputPeak      = 0.f;
+    _inputSquares   = 0.0;
+    _inputSamples   = 0;
+    _outputPeak     = 0.f;
+    _outputSquares  = 0.0;
+    _outputSamples  = 0;
+    _gainReduction  = 1.f;
+}
+
+Meter::Values Meter::read()
+{
+    Values values;
+    unsigned int before, after;
+
+    do {
+        before = _sequence.load( std::memory_order_acquire );
+
+        values.inputPeak     = _publishedInputPeak.load( std::memory_order_relaxed );
+        values.inputRMS      = _publishedInputRMS.load( std::memory_order_relaxed );
+        values.outputPeak    = _publishedOutputPeak.load( std::memory_order_relaxed );
+        values.outputRMS     = _publishedOutputRMS.load( std::memory_order_relaxed );
+        values.gainReduction = _publishedGainReduction.load( std::memory_order_relaxed );
+
+        std::atomic_thread_fence( std::memory_order_acquire );
+        after = _sequence.load( std::memory_order_relaxed );
+
+    } while (( before & 1 ) != 0 || before != after );
+
+    return values;
+}
+
+void Meter::setSampleRate( float sampleRate )
+{
+    _windowSize = std::max( 1, ( int ) ( sampleRate / UI_RATE ));
+}
+
+/* private methods */
+
+void Meter::publish()
+{
+    unsigned int sequence = _sequence.load( std::memory_order_relaxed );
+
+    _sequence.store( sequence + 1, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_release );
+
+    _publishedInputPeak.store( _inputPeak, std::memory_order_relaxed );
+    _publishedInputRMS.store( _inputSamples > 0 ? ( float ) sqrt( _inputSquares / _inputSamples ) : 0.f, std::memory_order_relaxed );
+    _publishedOutputPeak.store( _outputPeak, std::memory_order_relaxed );
+    _publishedOutputRMS.store( _outputSamples > 0 ? ( float ) sqrt( _outputSquares / _outputSamples ) : 0.f, std::memory_order_relaxed );
+    _publishedGainReduction.store( _gainReduction, std::memory_order_relaxed );
+
+    _sequence.store( sequence + 2, std::memory_order_release );
+}
+
+}
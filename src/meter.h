@@ -0,0 +1,140 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __METER_H_INCLUDED__
+#define __METER_H_INCLUDED__
+
+#include "global.h"
+#include "vectorops.h"
+#include <atomic>
+#include <math.h>
+
+namespace Igorski {
+
+/**
+ * Measures the input and output levels of the processor along with the gain reduction
+ * applied by the limiter. The levels are accumulated on the audio thread and published
+ * as a snapshot at UI rate, which can be read lock-free from any other thread
+ */
+class Meter
+{
+    public:
+        static constexpr float UI_RATE = 30.f; // amount of snapshots published per second
+
+        // the range of the normalized level and gain reduction values
+
+        static constexpr float MIN_DB                = -60.f;
+        static constexpr float MAX_DB                = 6.f;
+        static constexpr float MAX_GAIN_REDUCTION_DB = 24.f;
+
+        // all levels are linear amplitudes, gainReduction is the lowest gain
+        // applied by the limiter (e.g. 1 when no reduction took place)
+
+        struct Values {
+            float inputPeak     = 0.f;
+            float inputRMS      = 0.f;
+            float outputPeak    = 0.f;
+            float outputRMS     = 0.f;
+            float gainReduction = 1.f;
+        };
+
+        Meter( float sampleRate );
+
+        // accumulate the levels of the current block, note the input must be
+        // measured before processing (as processing may occur in place)
+
+        template <typename SampleType>
+        void measureInput( SampleType** buffer, int numChannels, int bufferSize );
+
+        template <typename SampleType>
+        void measureOutput( SampleType** buffer, int numChannels, int bufferSize );
+
+        void measureGainReduction( float linearGain );
+
+        // completes the measurement of the current block, publishing
+        // a new snapshot once enough samples for a UI frame have been measured
+
+        void update( int bufferSize );
+
+        // retrieve the last published snapshot, can be invoked from any thread
+
+        Values read();
+
+        void setSampleRate( float sampleRate );
+
+        // conversion of the values to normalized (0 - 1 range) parameter values and back
+
+        static inline float levelToNormalized( float linear ) {
+            if ( linear <= 0.f ) {
+                return 0.f;
+            }
+            float dB = 20.f * log10f( linear );
+            return fmin( 1.f, fmax( 0.f, ( dB - MIN_DB ) / ( MAX_DB - MIN_DB )));
+        }
+
+        static inline float normalizedToDecibels( float normalized ) {
+            return MIN_DB + normalized * ( MAX_DB - MIN_DB );
+        }
+
+        static inline float gainReductionToNormalized( float linearGain ) {
+            if ( linearGain >= 1.f ) {
+                return 0.f;
+            }
+            float dB = linearGain > 0.f ? -20.f * log10f( linearGain ) : MAX_GAIN_REDUCTION_DB;
+            return fmin( 1.f, dB / MAX_GAIN_REDUCTION_DB );
+        }
+
+        static inline float normalizedToGainReduction( float normalized ) {
+            return -normalized * MAX_GAIN_REDUCTION_DB;
+        }
+
+    private:
+        int _windowSize;      // amount of samples per UI frame
+        int _windowProgress = 0;
+
+        // accumulated values of the current frame
+
+        float  _inputPeak      = 0.f;
+        double _inputSquares   = 0.0;
+        int    _inputSamples   = 0;
+        float  _outputPeak     = 0.f;
+        double _outputSquares  = 0.0;
+        int    _outputSamples  = 0;
+        float  _gainReduction  = 1.f;
+
+        // published snapshot, guarded by a sequence counter which is odd while the
+        // audio thread is writing (readers retry when the counter changed during their read)
+
+        std::atomic<unsigned int> _sequence{ 0 };
+        std::atomic<float> _publishedInputPeak{ 0.f };
+        std::atomic<float> _publishedInputRMS{ 0.f };
+        std::atomic<float> _publishedOutputPeak{ 0.f };
+        std::atomic<float> _publishedOutputRMS{ 0.f };
+        std::atomic<float> _publishedGainReduction{ 1.f };
+
+        void publish();
+};
+}
+
+#include "meter.tcc"
+
+#endif
@@ -0,0 +1,118 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifdef DARVAZA_NULL_TEST
+
+#include "nulltest.h"
+#include <algorithm>
+#include <math.h>
+
+namespace Igorski {
+
+/* constructor */
+
+NullTest::NullTest( int amountOfChannels, const ProcessingContext& context )
+{
+    reference = new PluginProcess( amountOfChannels, context );
+    reference->deadlineMonitor->enableGovernor( false );
+
+    _input     = nullptr;
+    _output    = nullptr;
+    _sideChain = nullptr;
+
+    prepareBuffers( context.maxBlockSize );
+}
+
+NullTest::~NullTest()
+{
+    delete reference;
+    delete _input;
+    delete _output;
+    delete _sideChain;
+}
+
+/* public methods */
+
+void NullTest::setProcessingContext( const ProcessingContext& context )
+{
+    RT_ASSERT_NOT_REALTIME( "NullTest::setProcessingContext()" );
+
+    reference->setProcessingContext( context );
+    reference->deadlineMonitor->enableGovernor( false );
+
+    prepareBuffers( context.maxBlockSize );
+}
+
+NullTest::Result NullTest::getResult()
+{
+    Result result;
+
+    result.samples      = _samples;
+    result.bitExact     = _bitExact;
+    result.synchronized = _synchronized;
+
+    if ( _residualSquares > 0.0 ) {
+        // any residual against a silent reference is reported at 0 dB
+        double relative   = _referenceSquares > 0.0 ? _residualSquares / _referenceSquares : 1.0;
+        result.residualDb = std::max( MIN_DB, ( float ) ( 10.0 * log10( relative )));
+    }
+
+    if ( _peakResidual > 0.f ) {
+        result.peakResidualDb = std::max( MIN_DB, 20.f * log10f( _peakResidual ));
+    }
+    return result;
+}
+
+bool NullTest::passes( float toleranceDb )
+{
+    Result result = getResult();
+    return result.synchronized && ( result.bitExact || result.residualDb <= toleranceDb );
+}
+
+void NullTest::reset()
+{
+    _bitExact         = true;
+    _samples          = 0;
+    _residualSquares  = 0.0;
+    _referenceSquares = 0.0;
+    _peakResidual     = 0.f;
+}
+
+/* private methods */
+
+void NullTest::prepareBuffers( int bufferSize )
+{
+    if ( _input != nullptr && _input->bufferSize >= bufferSize ) {
+        return;
+    }
+    delete _input;
+    delete _output;
+    delete _sideChain;
+
+    _input     = new AudioBuffer( PluginProcess::MAX_CHANNELS, bufferSize );
+    _output    = new AudioBuffer( PluginProcess::MAX_CHANNELS, bufferSize );
+    _sideChain = new AudioBuffer( PluginProcess::MAX_CHANNELS, bufferSize );
+}
+
+}
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __NULLTEST_H_INCLUDED__
+#define __NULLTEST_H_INCLUDED__
+
+/**
+ * Debugging aid proving that the processing variants selected at runtime render the same output
+ * as the reference path, enabled by compiling with DARVAZA_NULL_TEST defined (see CMakeLists.txt).
+ * The NullTest runs a reference PluginProcess alongside the PluginProcess driven by the host. The
+ * reference renders a copy of the input through the plain path (32-bit samples, out of place) while
+ * the host drives the variant of its choosing (processing in place when it aliases the buffers,
+ * 64-bit samples for double precision hosts) after which the outputs are compared. The residual
+ * of the comparison (the difference of both outputs) is accumulated for the entire session.
+ *
+ * The reference must receive the same model and transport updates as the process under test. The
+ * quality governor is disabled on both, as its tiers depend on timing (see DeadlineMonitor).
+ */
+#ifdef DARVAZA_NULL_TEST
+
+#include "audiobuffer.h"
+#include "plugin_process.h"
+#include "processingcontext.h"
+
+namespace Igorski {
+
+class NullTest
+{
+    public:
+        // the residual (relative to the reference) below which a variant that is not bit-exact
+        // passes, e.g. for 64-bit processing which does not round to 32-bit between stages
+
+        static constexpr float TOLERANCE_DB = -90.f;
+        static constexpr float MIN_DB       = -200.f; // reported for a residual of silence
+
+        struct Result {
+            uint64 samples         = 0;       // amount of compared samples (per channel)
+            bool   bitExact        = true;
+            bool   synchronized    = true;    // false when the reference could no longer follow the process
+            float  residualDb      = MIN_DB;  // RMS of the residual relative to the RMS of the reference
+            float  peakResidualDb  = MIN_DB;  // peak of the residual in dBFS
+        };
+
+        NullTest( int amountOfChannels, const ProcessingContext& context );
+        ~NullTest();
+
+        // the reference process, apply all model and transport updates of the process under test onto it
+
+        PluginProcess* reference;
+
+        // applies given context onto the reference (sizing the buffers for its maximum block size)
+        // this allocates and should thus be invoked outside of the audio thread
+
+        void setProcessingContext( const ProcessingContext& context );
+
+        // renders the input through the reference, invoked before the process under test processes
+        // the same block (as processing in place overwrites the input)
+
+        template <typename SampleType>
+        void renderReference( SampleType** inBuffer, int numInChannels, int numOutChannels, int bufferSize,
+                              SampleType** sideChainBuffer, int numSideChainChannels );
+
+        // accumulates the residual of the output of the process under test
+        // against the output the reference rendered for the same block
+
+        template <typename SampleType>
+        void compare( SampleType** outBuffer, int numOutChannels, int bufferSize );
+
+        Result getResult();
+
+        // whether the output is bit-exact or its residual within given tolerance
+
+        bool passes( float toleranceDb = TOLERANCE_DB );
+
+        // clears the accumulated residual (the reference keeps its state)
+
+        void reset();
+
+    private:
+        AudioBuffer* _input;     // copy of the input (as float)
+        AudioBuffer* _output;    // output of the reference
+        AudioBuffer* _sideChain; // copy of the sidechain input (as float)
+
+        int  _renderedSamples = 0; // size of the last block rendered by the reference
+        int  _renderedChannels = 0;
+        bool _synchronized    = true;
+        bool _bitExact        = true;
+
+        uint64 _samples          = 0;
+        double _residualSquares  = 0.0;
+        double _referenceSquares = 0.0;
+        float  _peakResidual     = 0.f;
+
+        void prepareBuffers( int bufferSize );
+};
+}
+
+#include "nulltest.tcc"
+
+#endif
+
+#endif
@@ -0,0 +1,107 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <math.h>
+
+namespace Igorski
+{
+template <typename SampleType>
+void NullTest::renderReference( SampleType** inBuffer, int numInChannels, int numOutChannels, int bufferSize,
+                                SampleType** sideChainBuffer, int numSideChainChannels ) {
+
+    _renderedSamples = 0;
+
+    // should the host exceed the maximum block size or channel count, the reference can no
+    // longer process the same blocks as the process under test (and thus no longer compare)
+
+    if ( bufferSize > _input->bufferSize ||
+         numInChannels  > _input->amountOfChannels ||
+         numOutChannels > _output->amountOfChannels ||
+         numSideChainChannels > _sideChain->amountOfChannels ) {
+        _synchronized = false;
+    }
+
+    if ( !_synchronized || bufferSize <= 0 ) {
+        return;
+    }
+
+    float* inputs[ PluginProcess::MAX_CHANNELS ];
+    float* outputs[ PluginProcess::MAX_CHANNELS ];
+    float* sideChains[ PluginProcess::MAX_CHANNELS ];
+
+    for ( int c = 0; c < numInChannels; ++c ) {
+        inputs[ c ] = _input->getBufferForChannel( c );
+
+        for ( int i = 0; i < bufferSize; ++i ) {
+            inputs[ c ][ i ] = ( float ) inBuffer[ c ][ i ];
+        }
+    }
+
+    for ( int c = 0; c < numOutChannels; ++c ) {
+        outputs[ c ] = _output->getBufferForChannel( c );
+    }
+
+    for ( int c = 0; c < numSideChainChannels && sideChainBuffer != nullptr; ++c ) {
+        sideChains[ c ] = _sideChain->getBufferForChannel( c );
+
+        for ( int i = 0; i < bufferSize; ++i ) {
+            sideChains[ c ][ i ] = ( float ) sideChainBuffer[ c ][ i ];
+        }
+    }
+
+    reference->process<float>(
+        inputs, outputs, numInChannels, numOutChannels, bufferSize, ( uint32 ) ( sizeof( float ) * bufferSize ),
+        sideChainBuffer != nullptr ? sideChains : nullptr, sideChainBuffer != nullptr ? numSideChainChannels : 0
+    );
+
+    _renderedSamples  = bufferSize;
+    _renderedChannels = numOutChannels;
+}
+
+template <typename SampleType>
+void NullTest::compare( SampleType** outBuffer, int numOutChannels, int bufferSize ) {
+
+    if ( !_synchronized || bufferSize != _renderedSamples ) {
+        return;
+    }
+
+    for ( int c = 0; c < std::min( numOutChannels, _renderedChannels ); ++c ) {
+        SampleType* channelOutBuffer = outBuffer[ c ];
+        float* channelReference      = _output->getBufferForChannel( c );
+
+        for ( int i = 0; i < bufferSize; ++i ) {
+            SampleType referenceSample = ( SampleType ) channelReference[ i ];
+            double residual = ( double ) channelOutBuffer[ i ] - ( double ) referenceSample;
+
+            if ( residual != 0.0 ) {
+                _bitExact     = false;
+                _peakResidual = std::max( _peakResidual, ( float ) fabs( residual ));
+            }
+            _residualSquares  += residual * residual;
+            _referenceSquares += ( double ) referenceSample * referenceSample;
+        }
+    }
+    _samples += bufferSize;
+}
+
+}
@@ -0,0 +1,102 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "oscillator.h"
+#include <algorithm>
+
+namespace Igorski {
+
+/* constructor / destructor */
+
+Oscillator::Oscillator( WaveTable* waveTable, float aFrequency, float sampleRate )
+{
+    _accumulator = 0.0;
+    _sampleRate  = sampleRate;
+    setFrequency( aFrequency );
+    setTable( waveTable, false );
+}
+
+Oscillator::~Oscillator()
+{
+    // table is not owned by the Oscillator
+}
+
+/* public methods */
+
+void Oscillator::setTable( WaveTable* waveTable, bool crossfade )
+{
+    // crossfading is only possible between tables of equal length (as the read offset is shared)
+
+    if ( crossfade && _table != nullptr && _table->tableLength == waveTable->tableLength ) {
+        _previousBuffer = _buffer;
+        _fadeLength     = std::max( 1, ( int ) ( CROSSFADE_MS * 0.001f * _sampleRate ));
+        _fadeRemaining  = _fadeLength;
+    } else {
+        _previousBuffer = nullptr;
+        _fadeRemaining  = 0;
+    }
+    _table       = waveTable;
+    _buffer      = waveTable->getBuffer();
+    _tableLength = waveTable->tableLength;
+
+    _sampleRateOverLength = _sampleRate / ( float ) _tableLength;
+}
+
+WaveTable* Oscillator::getTable()
+{
+    return _table;
+}
+
+void Oscillator::setSampleRate( float sampleRate )
+{
+    // retain the phase by scaling the accumulator to the new rate
+
+    _accumulator *= sampleRate / _sampleRate;
+    _sampleRate   = sampleRate;
+    _sampleRateOverLength = _sampleRate / ( float ) _tableLength;
+
+    if ( _accumulator >= _sampleRate ) {
+        _accumulator = 0.f;
+    }
+}
+
+void Oscillator::setFrequency( float aFrequency )
+{
+    _frequency = aFrequency;
+}
+
+float Oscillator::getFrequency()
+{
+    return _frequency;
+}
+
+void Oscillator::setAccumulator( float value )
+{
+    _accumulator = value;
+}
+
+float Oscillator::getAccumulator()
+{
+    return _accumulator;
+}
+
+} // E.O namespace Igorski
@@ -0,0 +1,105 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __OSCILLATOR_H_INCLUDED__
+#define __OSCILLATOR_H_INCLUDED__
+
+#include "global.h"
+#include "wavetable.h"
+
+namespace Igorski {
+
+/**
+ * An Oscillator reads a (shared) WaveTable at a given frequency. The Oscillator only
+ * maintains the read position, the table itself is not owned nor modified, which allows
+ * multiple Oscillators to read from the same table and switch waveforms by swapping tables
+ */
+class Oscillator
+{
+    public:
+        static constexpr float CROSSFADE_MS = 5.f; // duration of the crossfade when switching tables
+
+        Oscillator( WaveTable* waveTable, float aFrequency, float sampleRate );
+        ~Oscillator();
+
+        // sets the table to read from, keeping the current phase. When crossfade is true,
+        // the output fades from the previous table into the new one over CROSSFADE_MS
+
+        void setTable( WaveTable* waveTable, bool crossfade );
+        WaveTable* getTable();
+
+        void setSampleRate( float sampleRate );
+
+        void setFrequency( float aFrequency );
+        float getFrequency();
+
+        // accumulators are used to retrieve a sample from the wave table
+
+        float getAccumulator();
+        void setAccumulator( float offset );
+
+        /**
+         * retrieve a value from the wave table for the current
+         * accumulator position, this method also increments
+         * the accumulator and keeps it within bounds
+         */
+        inline float peek()
+        {
+            // the wave table offset to read from (clamped as rounding can
+            // yield the table length for accumulators close to the sample rate)
+            int readOffset = ( _accumulator == 0 ) ? 0 : ( int ) ( _accumulator / _sampleRateOverLength );
+            if ( readOffset >= _tableLength )
+                readOffset = _tableLength - 1;
+
+            // increment the accumulators read offset
+            _accumulator += _frequency;
+
+            // keep the accumulator in the bounds of the sample frequency
+            if ( _accumulator >= _sampleRate )
+                _accumulator -= _sampleRate;
+
+            // return the sample present at the calculated offset within the table
+            float sample = _buffer[ readOffset ];
+
+            // fade from the sample at the same offset within the previous table (when switching tables)
+            if ( _fadeRemaining > 0 ) {
+                sample += ( _previousBuffer[ readOffset ] - sample ) * (( float ) _fadeRemaining / ( float ) _fadeLength );
+                --_fadeRemaining;
+            }
+            return sample;
+        }
+
+    private:
+        WaveTable* _table = nullptr;
+        float* _buffer;           // buffer of the current table
+        float* _previousBuffer;   // buffer of the table faded out from (when switching tables)
+        float _accumulator;       // is read offset in wave table buffer
+        float _frequency;         // frequency (in Hz) of waveform cycle when reading
+        float _sampleRate;
+        float _sampleRateOverLength;
+        int _tableLength;
+        int _fadeLength    = 0;
+        int _fadeRemaining = 0;
+};
+} // E.O namespace Igorski
+
+#endif
@@ -46,7 +46,38 @@ enum
 // --- AUTO-GENERATED END
 
 	kBypassId, // bypass process
-    kVuPPMId // for the Vu value return to host
+    kVuPPMId, // for the Vu value return to host (output peak)
+
+    // read-only meter values, reported by the processor
+
+    kOutputRMSId,
+    kInputPeakId,
+    kInputRMSId,
+    kGainReductionId,
+
+    // sidechain gate
+
+    kGateModeId,
+    kSideChainAttackId,
+    kSideChainReleaseId,
+    kSideChainThresholdId,
+
+    // read-only processing state, reported by the processor
+
+    kProcessLoadId,
+    kQualityTierId,
+
+    // output limiter
+
+    kLimiterModeId,
+
+    // algorithmic reverb engine (used when no impulse response is loaded)
+
+    kReverbEngineId,
+
+    // processing quality (automatic follows the process mode of the host)
+
+    kQualityModeId
 };
 
 #endif
@@ -24,85 +24,170 @@
 #include "calc.h"
 #include "tablepool.h"
 #include "waveforms.h"
+#include "wavfile.h"
+#include "pluginterfaces/vst/ivstaudioprocessor.h"
 #include <math.h>
+#include <string.h>
 
 namespace Igorski {
 
-PluginProcess::PluginProcess( int amountOfChannels ) {
+PluginProcess::PluginProcess( int amountOfChannels, const ProcessingContext& context ) {
+    _context          = context;
     _amountOfChannels = amountOfChannels;
-    _maxDownSample    = VST::SAMPLE_RATE / MIN_SAMPLE_RATE;
+    _maxDownSample    = _context.sampleRate / MIN_SAMPLE_RATE;
 
-    // cache the waveforms (as sample rate is known to be accurate on PluginProcess construction)
-
-    TablePool::setTable( WaveGenerator::generate( WaveGenerator::WaveForms::SINE ),     WaveGenerator::WaveForms::SINE );
-    TablePool::setTable( WaveGenerator::generate( WaveGenerator::WaveForms::TRIANGLE ), WaveGenerator::WaveForms::TRIANGLE );
-    TablePool::setTable( WaveGenerator::generate( WaveGenerator::WaveForms::SAWTOOTH ), WaveGenerator::WaveForms::SAWTOOTH );
-    TablePool::setTable( WaveGenerator::generate( WaveGenerator::WaveForms::SQUARE ),   WaveGenerator::WaveForms::SQUARE );
+    // retrieve the waveforms from the pool (as sample rate is known to be accurate on PluginProcess construction)
 
+    for ( int i = 0; i < WaveGenerator::AMOUNT_OF_WAVEFORMS; ++i ) {
+        _gateTables[ i ] = nullptr;
+    }
     _gateWaveForm = WaveGenerator::WaveForms::SINE;
-    for ( size_t i = 0; i < _amountOfChannels; ++i ) {
-        _waveTables.push_back( TablePool::getTable( _gateWaveForm )->clone() );
+    acquireGateTables( _context.sampleRate );
+
+    // the state of all child processors is laid out back to back within a single
+    // arena (sized up front), so it is created with a single allocation. What remains
+    // allocated separately : the gate tables (pooled and shared between instances), the
+    // record, mix and bypass buffers (resized to the block size and sample rate), the
+    // convolution reverbs (created when loading an impulse response), the vectors
+    // listing the per-channel processors and the profiler (in DARVAZA_PROFILE builds)
+
+    size_t arenaSize = Arena::sizeOf<BitCrusher>() + Arena::sizeOf<Limiter>() + Arena::sizeOf<Meter>() +
+                       Arena::sizeOf<float>( Limiter::getLookaheadMemorySize( amountOfChannels, LIMITER_LOOKAHEAD_MS )) +
+                       Arena::sizeOf<uint32_t>( Limiter::getLookaheadPositionsSize( LIMITER_LOOKAHEAD_MS )) +
+                       Arena::sizeOf<DeadlineMonitor>() + Arena::sizeOf<EnvelopeFollower>() +
+                       Arena::sizeOf<float>( amountOfChannels ) * 3;
+
+    for ( int i = 0; i < amountOfChannels; ++i ) {
+        arenaSize += Arena::sizeOf<Oscillator>() + Arena::sizeOf<LowPassFilter>() +
+                     Arena::sizeOf<Reverb>()    + Arena::sizeOf<float>( Reverb::getLineMemorySize()) +
+                     Arena::sizeOf<FDNReverb>() + Arena::sizeOf<float>( FDNReverb::getLineMemorySize( i ));
+    }
+    _arena = new Arena( arenaSize );
+
+    for ( int i = 0; i < amountOfChannels; ++i ) {
+        _oscillators.push_back( _arena->create<Oscillator>( _gateTables[ _gateWaveForm ], 440.f, _context.sampleRate ));
     }
 
-    // these will be synced to host, see vst.cpp. here we default to 120 BPM in 4/4 time
+    // these will be synced to host, see vst.cpp. here we default to the context tempo in 4/4 time
 
-    setTempo( 120.0, 4, 4 );
+    setTempo( _context.tempo, 4, 4 );
 
     // child processors that can work on any audio channel
     // (e.g. don't maintain the last channel-specific state)
 
-    bitCrusher = new BitCrusher( 8, .5f, .5f );
-    limiter    = new Limiter( 10.f, 500.f, .6f );
+    bitCrusher = _arena->create<BitCrusher>( 8, .5f, .5f );
+    limiter    = _arena->create<Limiter>( 10.f, 500.f, .6f );
+
+    limiter->setSampleRate( _context.sampleRate );
+
+    // the output is limited ahead of its (inter-sample) peaks so it never exceeds the ceiling
+
+    float* limiterMemory       = _arena->createArray<float>( Limiter::getLookaheadMemorySize( amountOfChannels, LIMITER_LOOKAHEAD_MS ));
+    uint32_t* limiterPositions = _arena->createArray<uint32_t>( Limiter::getLookaheadPositionsSize( LIMITER_LOOKAHEAD_MS ));
+    limiter->enableLookahead( amountOfChannels, LIMITER_LOOKAHEAD_MS, LIMITER_CEILING_DB, true, limiterMemory, limiterPositions );
+
+    meter = _arena->create<Meter>( _context.sampleRate );
+
+    // the quality is only governed when processing in real-time (there is no deadline when rendering offline),
+    // regardless of the quality mode (which determines which tiers the governor can step through)
+
+    deadlineMonitor = _arena->create<DeadlineMonitor>( _context.sampleRate );
+    deadlineMonitor->enableGovernor( _context.processMode == Vst::kRealtime );
+
+    _envelopeFollower = _arena->create<EnvelopeFollower>( _context.sampleRate );
+
+#ifdef DARVAZA_PROFILE
+    profiler = new Profiler();
+#endif
 
     // child processors and properties that work on individual channels
 
-    _lastSamples  = new float[ amountOfChannels ];
-    _readPointers = new float[ amountOfChannels ];
+    _lastSamples  = _arena->createArray<float>( amountOfChannels );
+    _readPointers = _arena->createArray<float>( amountOfChannels );
+    _crushInputs  = _arena->createArray<float>( amountOfChannels );
 
     for ( int i = 0; i < amountOfChannels; ++i ) {
-        _lastSamples[ i ]  = 0.f;
-        _readPointers[ i ] = 0.f;
-
-        _lowPassFilters.push_back( new LowPassFilter());
+        _lowPassFilters.push_back( _arena->create<LowPassFilter>());
 
-        Reverb* reverb = new Reverb();
+        float* reverbLines = _arena->createArray<float>( Reverb::getLineMemorySize());
+        Reverb* reverb     = _arena->create<Reverb>( _context.sampleRate, reverbLines );
         reverb->setWidth( 1.f );
         reverb->setRoomSize( 1.f );
 
         _reverbs.push_back( reverb );
+
+        float* fdnLines      = _arena->createArray<float>( FDNReverb::getLineMemorySize( i ));
+        FDNReverb* fdnReverb = _arena->create<FDNReverb>( i, _context.sampleRate, fdnLines );
+        fdnReverb->setWidth( 1.f );
+        fdnReverb->setRoomSize( 1.f );
+
+        _fdnReverbs.push_back( fdnReverb );
     }
 
+    // every allocation above must have been accounted for in the arena size (allocations
+    // beyond the capacity are caught by Arena::allocate())
+
+    _arena->verifyExhausted( "PluginProcess" );
+
     setPlaybackRate( 1.f );
     setResampleRate( 1.f );
+    applyQualityMode( getAutomaticQualityMode() );
 
-    // will be lazily created in the process function
+    // created for the maximum block size up front, as processing must not allocate
     _recordBuffer = nullptr;
     _preMixBuffer = nullptr;
+
+    prepareMixBuffers( _context.maxBlockSize );
+    prepareBypassLines();
 }
 
 PluginProcess::~PluginProcess() {
-    delete bitCrusher;
-    delete limiter;
+    // destroy the child processors created within the arena, after which its memory is freed at once
 
-    delete[] _lastSamples;
-    delete[] _readPointers;
+    Arena::destroy( bitCrusher );
+    Arena::destroy( limiter );
+    Arena::destroy( meter );
+    Arena::destroy( deadlineMonitor );
+    Arena::destroy( _envelopeFollower );
 
-    while ( _lowPassFilters.size() > 0 ) {
-        delete _lowPassFilters.at( 0 );
-        _lowPassFilters.erase( _lowPassFilters.begin() );
+    for ( auto lowPassFilter : _lowPassFilters ) {
+        Arena::destroy( lowPassFilter );
     }
-
-    while ( _reverbs.size() > 0 ) {
-        delete _reverbs.at( 0 );
-        _reverbs.erase( _reverbs.begin() );
+    for ( auto reverb : _reverbs ) {
+        Arena::destroy( reverb );
+    }
+    for ( auto fdnReverb : _fdnReverbs ) {
+        Arena::destroy( fdnReverb );
     }
+    for ( auto oscillator : _oscillators ) {
+        Arena::destroy( oscillator );
+    }
+    _oscillators.clear();
+    _lowPassFilters.clear();
+    _reverbs.clear();
+    _fdnReverbs.clear();
+
+    delete _arena;
+
+    // as the audio thread is no longer running, any set of convolution reverbs can be freed
+
+    deleteConvolutionReverbs( _convolutionReverbs );
+    deleteConvolutionReverbs( _pendingConvolutionReverbs.exchange( nullptr ));
+    deleteConvolutionReverbs( _retiredConvolutionReverbs.exchange( nullptr ));
+
+    delete _impulseResponse;
 
     delete _preMixBuffer;
     delete _recordBuffer;
+    delete _gateLevelBuffer;
 
-    clearGateTables();
+    delete[] _bypassLines;
+    delete[] _bypassScratch;
 
-    TablePool::flush();
+#ifdef DARVAZA_PROFILE
+    delete profiler;
+#endif
+    clearGateTables();
 }
 
 /* setters */
@@ -133,7 +218,7 @@ void PluginProcess::setGateSpeed( float oddSteps, float evenSteps, bool linkGate
         for ( size_t i = 0; i < _amountOfChannels; ++i ) {
             bool isEvenChannel = ( i % 2 ) == 1;
             if ( isEvenChannel ) {
-                _waveTables.at( i )->setAccumulator( _waveTables.at( i - 1 )->getAccumulator() );
+                _oscillators.at( i )->setAccumulator( _oscillators.at( i - 1 )->getAccumulator() );
             }
         }
     }
@@ -152,7 +237,7 @@ void PluginProcess::setOddGateSpeed( float steps ) {
     for ( size_t i = 0; i < _amountOfChannels; ++i ) {
         bool isOddChannel = ( i % 2 ) == 0;
         if ( isOddChannel ) {
-            _waveTables.at( i )->setFrequency( value );
+            _oscillators.at( i )->setFrequency( value );
         }
     }
 }
@@ -165,7 +250,7 @@ void PluginProcess::setEvenGateSpeed( float steps ) {
     for ( size_t i = 0; i < _amountOfChannels; ++i ) {
         bool isEvenChannel = ( i % 2 ) == 1;
         if ( isEvenChannel ) {
-            _waveTables.at( i )->setFrequency( value );
+            _oscillators.at( i )->setFrequency( value );
         }
     }
 }
@@ -192,15 +277,15 @@ void PluginProcess::resetReadWritePointers()
 
 void PluginProcess::resetGates()
 {
-    for ( auto waveTable : _waveTables ) {
-        waveTable->setAccumulator( 0 );
+    for ( auto oscillator : _oscillators ) {
+        oscillator->setAccumulator( 0 );
     }
 }
 
 void PluginProcess::clearRecordBuffer()
 {
     if ( _recordBuffer != nullptr ) {
-        _recordBuffer->silenceBuffers();
+        _recordBuffer->clear();
     }
 }
 
@@ -307,11 +392,83 @@ void PluginProcess::setHarmony( float value )
     _evenPitch = Calc::pitchDown( even );
 }
 
+void PluginProcess::setGateMode( float value )
+{
+    _gateMode = ( GateModes ) ( int ) round( Calc::cap( value ) * GateModes::SIDECHAIN_RMS );
+
+    _envelopeFollower->setDetectionMode(
+        _gateMode == GateModes::SIDECHAIN_RMS ? EnvelopeFollower::DetectionModes::RMS : EnvelopeFollower::DetectionModes::PEAK
+    );
+}
+
+void PluginProcess::setSideChainAttack( float value )
+{
+    _envelopeFollower->setAttack( Calc::scaleExponential( value, MIN_SIDECHAIN_ATTACK_MS, MAX_SIDECHAIN_ATTACK_MS ));
+}
+
+void PluginProcess::setSideChainRelease( float value )
+{
+    _envelopeFollower->setRelease( Calc::scaleExponential( value, MIN_SIDECHAIN_RELEASE_MS, MAX_SIDECHAIN_RELEASE_MS ));
+}
+
+void PluginProcess::setSideChainThreshold( float value )
+{
+    _envelopeFollower->setThreshold( MIN_SIDECHAIN_THRESHOLD_DB * ( 1.f - value ));
+}
+
+void PluginProcess::setLimiterMode( float value )
+{
+    LimiterModes mode = toLimiterMode( value );
+
+    if ( mode == _limiterMode ) {
+        return;
+    }
+    _limiterMode = mode;
+
+    limiter->setLookahead( mode != LimiterModes::CLASSIC, mode == LimiterModes::TRUE_PEAK && _qualityTier < QualityTiers::NO_OVERSAMPLING );
+    updateQualityTiers();
+
+    // the bypass lines follow the latency of the new mode (their contents no longer align)
+
+    _bypassLatency = limiter->getLatency();
+    memset( _bypassLines, 0, _amountOfChannels * _bypassLineSize * sizeof( double ));
+}
+
+PluginProcess::LimiterModes PluginProcess::toLimiterMode( float value )
+{
+    return ( LimiterModes ) ( int ) round( Calc::cap( value ) * LimiterModes::TRUE_PEAK );
+}
+
+int PluginProcess::getLatency()
+{
+    return limiter->getLatency();
+}
+
+int PluginProcess::calculateLatency( LimiterModes mode, float sampleRate )
+{
+    return mode == LimiterModes::CLASSIC ? 0 : Limiter::calculateLatency( LIMITER_LOOKAHEAD_MS, sampleRate );
+}
+
 void PluginProcess::enableReverb( bool enabled )
 {
     _reverbEnabled = enabled;
 }
 
+void PluginProcess::setReverbEngine( ReverbEngines engine )
+{
+    _reverbEngine = engine;
+}
+
+PluginProcess::ReverbEngines PluginProcess::getReverbEngine()
+{
+    return _reverbEngine;
+}
+
+PluginProcess::ReverbEngines PluginProcess::toReverbEngine( float value )
+{
+    return value >= .5f ? ReverbEngines::FDN : ReverbEngines::FREEVERB;
+}
+
 void PluginProcess::enableReverse( bool enabled )
 {
     _reverse = enabled;
@@ -319,23 +476,285 @@ void PluginProcess::enableReverse( bool enabled )
 
 /* other */
 
+void PluginProcess::setProcessingContext( const ProcessingContext& context )
+{
+    _context.maxBlockSize = context.maxBlockSize;
+    _context.processMode  = context.processMode;
+
+    if ( _qualitySelection == QualitySelections::AUTOMATIC_QUALITY ) {
+        applyQualityMode( getAutomaticQualityMode() );
+    }
+    deadlineMonitor->enableGovernor( context.processMode == Vst::kRealtime );
+
+    if ( context.sampleRate != _context.sampleRate ) {
+        setSampleRate( context.sampleRate );
+    }
+
+    // the record buffer duration is expressed in seconds, ensure the buffers
+    // can hold the maximum block size at the current sample rate
+
+    prepareMixBuffers( context.maxBlockSize );
+}
+
+const ProcessingContext& PluginProcess::getProcessingContext()
+{
+    return _context;
+}
+
+Arena* PluginProcess::getArena()
+{
+    return _arena;
+}
+
+void PluginProcess::setQualityMode( QualityModes mode )
+{
+    _qualitySelection = ( mode == QualityModes::OFFLINE ) ? QualitySelections::OFFLINE_QUALITY : QualitySelections::REALTIME_QUALITY;
+    applyQualityMode( mode );
+}
+
+void PluginProcess::setQualitySelection( float value )
+{
+    QualitySelections selection = toQualitySelection( value );
+
+    if ( selection == _qualitySelection ) {
+        return;
+    }
+
+    switch ( selection ) {
+        default:
+            _qualitySelection = selection;
+            applyQualityMode( getAutomaticQualityMode() );
+            break;
+        case QualitySelections::REALTIME_QUALITY:
+            setQualityMode( QualityModes::REALTIME );
+            break;
+        case QualitySelections::OFFLINE_QUALITY:
+            setQualityMode( QualityModes::OFFLINE );
+            break;
+    }
+}
+
+PluginProcess::QualitySelections PluginProcess::getQualitySelection()
+{
+    return _qualitySelection;
+}
+
+PluginProcess::QualitySelections PluginProcess::toQualitySelection( float value )
+{
+    return ( QualitySelections ) ( int ) round( Calc::cap( value ) * QualitySelections::OFFLINE_QUALITY );
+}
+
+void PluginProcess::applyQualityMode( QualityModes mode )
+{
+    _qualityMode = mode;
+
+    for ( auto reverb : _reverbs ) {
+        reverb->setDense( mode == QualityModes::OFFLINE );
+    }
+    updateQualityTiers();
+}
+
+PluginProcess::QualityModes PluginProcess::getQualityMode()
+{
+    return _qualityMode;
+}
+
+PluginProcess::QualityModes PluginProcess::getAutomaticQualityMode()
+{
+    return _context.processMode == Vst::kOffline ? QualityModes::OFFLINE : QualityModes::REALTIME;
+}
+
+PluginProcess::QualityTiers PluginProcess::getQualityTier()
+{
+    int tier = std::min( deadlineMonitor->read().tier, deadlineMonitor->getAmountOfTiers() - 1 );
+    return _qualityTiers[ std::max( 0, tier )];
+}
+
+void PluginProcess::setSampleRate( float sampleRate )
+{
+    _context.sampleRate = sampleRate;
+    _maxDownSample      = sampleRate / MIN_SAMPLE_RATE;
+
+    limiter->setSampleRate( sampleRate );
+    meter->setSampleRate( sampleRate );
+    prepareBypassLines(); // the limiter latency is expressed in samples
+    deadlineMonitor->setSampleRate( sampleRate );
+    _envelopeFollower->setSampleRate( sampleRate );
+
+    for ( auto reverb : _reverbs ) {
+        reverb->setSampleRate( sampleRate );
+    }
+
+    for ( auto fdnReverb : _fdnReverbs ) {
+        fdnReverb->setSampleRate( sampleRate );
+    }
+
+    for ( auto oscillator : _oscillators ) {
+        oscillator->setSampleRate( sampleRate );
+    }
+    acquireGateTables( sampleRate );
+
+    // musical positions are expressed in samples, recalculate these for the new rate
+
+    calculateMeasureSamples();
+
+    // the impulse response is resampled to the processing rate, recreate the convolution reverbs
+
+    if ( _impulseResponse != nullptr ) {
+        createConvolutionReverbs( sampleRate );
+    }
+}
+
+bool PluginProcess::loadImpulseResponse( const char* path )
+{
+    float sampleRate = 0.f;
+    AudioBuffer* impulseResponse = WavFile::read( path, sampleRate );
+
+    if ( impulseResponse == nullptr ) {
+        return false;
+    }
+
+    delete _impulseResponse;
+
+    _impulseResponse           = impulseResponse;
+    _impulseResponseSampleRate = sampleRate;
+
+    createConvolutionReverbs( _context.sampleRate );
+
+    return true;
+}
+
+void PluginProcess::clearImpulseResponse()
+{
+    delete _impulseResponse;
+    _impulseResponse = nullptr;
+
+    // hand an empty set to the audio thread, which stops convolution
+    // and releases the current set (see swapConvolutionReverbs())
+
+    deleteConvolutionReverbs( _pendingConvolutionReverbs.exchange( new ConvolutionReverbs()));
+    collectConvolutionReverbs();
+}
+
+bool PluginProcess::hasImpulseResponse()
+{
+    return _impulseResponse != nullptr;
+}
+
+void PluginProcess::createConvolutionReverbs( float sampleRate )
+{
+    // resample the impulse response to the processing rate (linear interpolation suffices as
+    // the response is a smooth decay in which the highest frequencies have little energy)
+
+    float ratio  = _impulseResponseSampleRate / sampleRate;
+    int length   = std::min(( int ) ( _impulseResponse->bufferSize / ratio ), ( int ) ( MAX_IMPULSE_SECONDS * sampleRate ));
+    float* taps  = new float[ std::max( 1, length ) ];
+
+    ConvolutionReverbs* reverbs = new ConvolutionReverbs();
+
+    for ( int c = 0; c < _amountOfChannels; ++c ) {
+
+        // channels beyond those available in the impulse response reuse its channels
+
+        float* source    = _impulseResponse->getBufferForChannel( c % _impulseResponse->amountOfChannels );
+        int maxReadIndex = _impulseResponse->bufferSize - 1;
+        float energy     = 0.f;
+
+        for ( int i = 0; i < length; ++i ) {
+            float position = i * ratio;
+            int index      = std::min(( int ) position, maxReadIndex );
+            int nextIndex  = std::min( index + 1, maxReadIndex );
+            float fraction = position - ( float ) index;
+
+            taps[ i ] = source[ index ] + ( source[ nextIndex ] - source[ index ] ) * fraction;
+            energy   += taps[ i ] * taps[ i ];
+        }
+
+        // normalize the response energy so its loudness is in line with the algorithmic reverbs
+
+        if ( energy > 0.f ) {
+            float gain = sqrt( IMPULSE_RESPONSE_ENERGY / energy );
+            for ( int i = 0; i < length; ++i ) {
+                taps[ i ] *= gain;
+            }
+        }
+        reverbs->push_back( new ConvolutionReverb( taps, length ));
+    }
+    delete[] taps;
+
+    // a set that was not yet picked up by the audio thread can be replaced directly
+
+    deleteConvolutionReverbs( _pendingConvolutionReverbs.exchange( reverbs ));
+    collectConvolutionReverbs();
+}
+
+void PluginProcess::collectConvolutionReverbs()
+{
+    // free the set the audio thread has released since the last update, note this is invoked after
+    // posting a new set, as the audio thread only swaps in a new set once the retired set has been collected
+
+    deleteConvolutionReverbs( _retiredConvolutionReverbs.exchange( nullptr ));
+}
+
+void PluginProcess::swapConvolutionReverbs()
+{
+    // invoked on the audio thread, the current set is only replaced when the previously
+    // replaced set has been collected, so the audio thread never has to free memory
+
+    if ( _retiredConvolutionReverbs.load() != nullptr ) {
+        return;
+    }
+
+    ConvolutionReverbs* reverbs = _pendingConvolutionReverbs.exchange( nullptr );
+
+    if ( reverbs == nullptr ) {
+        return;
+    }
+
+    // align the freeze state with that of the other reverb engines (note an empty set removes convolution)
+
+    for ( size_t c = 0; c < reverbs->size(); ++c ) {
+        reverbs->at( c )->setMode( _reverbs.at( c )->getMode() );
+    }
+
+    _retiredConvolutionReverbs.store( _convolutionReverbs );
+    _convolutionReverbs = reverbs;
+}
+
+void PluginProcess::deleteConvolutionReverbs( ConvolutionReverbs* reverbs )
+{
+    if ( reverbs == nullptr ) {
+        return;
+    }
+
+    for ( auto reverb : *reverbs ) {
+        delete reverb;
+    }
+    delete reverbs;
+}
+
 bool PluginProcess::setTempo( double tempo, int32 timeSigNumerator, int32 timeSigDenominator )
 {
-    if ( _tempo == tempo && _timeSigNumerator == timeSigNumerator && _timeSigDenominator == timeSigDenominator ) {
+    if ( _context.tempo == tempo && _timeSigNumerator == timeSigNumerator && _timeSigDenominator == timeSigDenominator ) {
         return false; // no change
     }
 
     _timeSigNumerator   = timeSigNumerator;
     _timeSigDenominator = timeSigDenominator;
-    _tempo              = tempo;
+    _context.tempo      = tempo;
+
+    calculateMeasureSamples();
+
+    return true;
+}
 
-    _fullMeasureDuration = ( 60.f / _tempo ) * _timeSigDenominator; // seconds per measure
-    _fullMeasureSamples  = Calc::secondsToBuffer( _fullMeasureDuration );
+void PluginProcess::calculateMeasureSamples()
+{
+    _fullMeasureDuration = ( 60.f / _context.tempo ) * _timeSigDenominator; // seconds per measure
+    _fullMeasureSamples  = Calc::secondsToBuffer( _fullMeasureDuration, _context.sampleRate );
     _halfMeasureSamples  = ceil( _fullMeasureSamples / 2 );
     _beatSamples         = ceil( _fullMeasureSamples / _timeSigDenominator );
     _sixteenthSamples    = ceil( _fullMeasureSamples / 16 );
-
-    return true;
 }
 
 void PluginProcess::createGateTables( float normalizedWaveFormType ) {
@@ -355,16 +774,13 @@ void PluginProcess::createGateTables( float normalizedWaveFormType ) {
 
     _gateWaveForm = waveForm;
 
-    // we keep the wave tables as they are and update their buffer contents
-    // (this keeps accumulator position and thus phase as-is)
+    // we keep the oscillators as they are and point them to the shared table of the new waveform
+    // (this keeps accumulator position and thus phase as-is, the waveforms are crossfaded to prevent clicks)
 
-    float* newBuffer = TablePool::getTable( waveForm )->getBuffer();
+    WaveTable* table = _gateTables[ waveForm ];
 
-    for ( size_t c = 0; c < _amountOfChannels; ++c ) {
-        float* buffer = _waveTables.at( c )->getBuffer();
-        for ( size_t i = 0; i < Igorski::VST::TABLE_SIZE; ++i ) {
-            buffer[ i ] = newBuffer[ i ];
-        }
+    for ( auto oscillator : _oscillators ) {
+        oscillator->setTable( table, true );
     }
 }
 
@@ -374,10 +790,115 @@ void PluginProcess::syncGates() {
 
 /* private methods */
 
+void PluginProcess::prepareMixBuffers( int bufferSize )
+{
+    RT_ASSERT_NOT_REALTIME( "PluginProcess::prepareMixBuffers" );
+
+    bufferSize = std::max( 1, bufferSize );
+
+    // if the record buffer wasn't created yet or is too small for the current sample rate and buffer
+    // size delete existing buffer and create new one to match properties. Note the record buffer must
+    // be at least twice the buffer size as reads can extend beyond its size by the buffer size
+
+    int idealRecordSize = Calc::secondsToBuffer( MAX_RECORD_SECONDS, _context.sampleRate );
+    int recordSize      = std::max( idealRecordSize, bufferSize * 2 );
+
+    if ( _recordBuffer == nullptr || _recordBuffer->size < recordSize ) {
+        delete _recordBuffer;
+        _recordBuffer = new RingBuffer( _amountOfChannels, recordSize );
+        resetReadWritePointers();
+    }
+
+    // if the mix buffers weren't created yet or are too small for the buffer
+    // size delete existing buffers and create new ones to match properties
+
+    if ( _preMixBuffer == nullptr || _preMixBuffer->bufferSize < bufferSize ) {
+        delete _preMixBuffer;
+        _preMixBuffer = new AudioBuffer( _amountOfChannels, bufferSize );
+
+        delete _gateLevelBuffer;
+        _gateLevelBuffer = new AudioBuffer( 1, bufferSize );
+    }
+}
+
+void PluginProcess::prepareBypassLines()
+{
+    RT_ASSERT_NOT_REALTIME( "PluginProcess::prepareBypassLines" );
+
+    // sized for the mode with the highest latency, so switching modes never has to allocate
+
+    _bypassLineSize = std::max( 1, calculateLatency( LimiterModes::TRUE_PEAK, _context.sampleRate ));
+    _bypassLatency  = limiter->getLatency();
+
+    delete[] _bypassLines;
+    delete[] _bypassScratch;
+
+    _bypassLines   = new double[ _amountOfChannels * _bypassLineSize ]();
+    _bypassScratch = new double[ _bypassLineSize ];
+}
+
+void PluginProcess::applyQualityTier( QualityTiers tier )
+{
+    _qualityTier = tier;
+
+    for ( auto reverb : _reverbs ) {
+        reverb->setEconomy( tier >= QualityTiers::REDUCED_REVERB );
+    }
+
+    // the lookahead (and thus the latency) remains, only its peak detection is simplified
+
+    limiter->setLookahead( _limiterMode != LimiterModes::CLASSIC,
+                           _limiterMode == LimiterModes::TRUE_PEAK && tier < QualityTiers::NO_OVERSAMPLING );
+}
+
+void PluginProcess::updateQualityTiers()
+{
+    // only the tiers that economize on something in the current modes can be stepped through
+
+    bool highQuality  = _qualityMode == QualityModes::OFFLINE;
+    int amountOfTiers = 0;
+
+    _qualityTiers[ amountOfTiers++ ] = QualityTiers::FULL_QUALITY;
+
+    if ( highQuality ) {
+        _qualityTiers[ amountOfTiers++ ] = QualityTiers::LINEAR_INTERPOLATION;
+    }
+    _qualityTiers[ amountOfTiers++ ] = QualityTiers::REDUCED_REVERB;
+
+    if ( highQuality || _limiterMode == LimiterModes::TRUE_PEAK ) {
+        _qualityTiers[ amountOfTiers++ ] = QualityTiers::NO_OVERSAMPLING;
+    }
+    deadlineMonitor->setAmountOfTiers( amountOfTiers );
+}
+
 void PluginProcess::clearGateTables() {
-    while ( _waveTables.size() > 0 ) {
-        delete _waveTables.at( 0 );
-        _waveTables.erase( _waveTables.begin() );
+    for ( int i = 0; i < WaveGenerator::AMOUNT_OF_WAVEFORMS; ++i ) {
+        if ( _gateTables[ i ] != nullptr ) {
+            TablePool::release( _gateTables[ i ] );
+            _gateTables[ i ] = nullptr;
+        }
+    }
+}
+
+void PluginProcess::acquireGateTables( float sampleRate ) {
+    // retrieve the tables for the given rate before releasing the current ones, so the tables
+    // remain pooled when the rate is unchanged (or when other instances still reference them)
+
+    WaveTable* previousTables[ WaveGenerator::AMOUNT_OF_WAVEFORMS ];
+
+    for ( int i = 0; i < WaveGenerator::AMOUNT_OF_WAVEFORMS; ++i ) {
+        previousTables[ i ] = _gateTables[ i ];
+        _gateTables[ i ]    = TablePool::acquire(( WaveGenerator::WaveForms ) i, sampleRate, VST::TABLE_SIZE );
+    }
+
+    for ( auto oscillator : _oscillators ) {
+        oscillator->setTable( _gateTables[ _gateWaveForm ], false );
+    }
+
+    for ( int i = 0; i < WaveGenerator::AMOUNT_OF_WAVEFORMS; ++i ) {
+        if ( previousTables[ i ] != nullptr ) {
+            TablePool::release( previousTables[ i ] );
+        }
     }
 }
 
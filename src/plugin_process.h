@@ -24,14 +24,26 @@
 #define __PLUGIN_PROCESS__H_INCLUDED__
 
 #include "global.h"
+#include "arena.h"
 #include "audiobuffer.h"
 #include "bitcrusher.h"
+#include "convolutionreverb.h"
+#include "deadlinemonitor.h"
+#include "envelopefollower.h"
+#include "fdnreverb.h"
 #include "limiter.h"
 #include "lowpassfilter.h"
+#include "meter.h"
+#include "oscillator.h"
+#include "processingcontext.h"
+#include "profiler.h"
+#include "realtimecheck.h"
 #include "reverb.h"
+#include "ringbuffer.h"
 #include "wavegenerator.h"
 #include "wavetable.h"
 #include "snd.h"
+#include <atomic>
 #include <vector>
 
 using namespace Steinberg;
@@ -41,32 +53,134 @@ class PluginProcess {
 
     // dithering constants
 
+    static const int DITHER_NOISE_MAX = 0x7fffffff; // range of ditherNoise()
+
     const float DITHER_WORD_LENGTH = pow( 2.0, 15 );        // 15 implies 16-bit depth
     const float DITHER_WI          = 1.0f / DITHER_WORD_LENGTH;
     const float DITHER_DC_OFFSET   = DITHER_WI * 0.5f;      // apply in resampling routine to remove DC offset
-    const float DITHER_AMPLITUDE   = DITHER_WI / RAND_MAX;  // 2 LSB
+    const float DITHER_AMPLITUDE   = DITHER_WI / DITHER_NOISE_MAX; // 2 LSB
 
     public:
-        static constexpr float MAX_RECORD_SECONDS = 30.f;
-        static constexpr float MIN_PLAYBACK_SPEED = .5f;
-        static constexpr float MIN_SAMPLE_RATE    = 2000.f;
-
-        PluginProcess( int amountOfChannels );
+        static constexpr float MAX_RECORD_SECONDS      = 30.f;
+        static constexpr float MIN_PLAYBACK_SPEED      = .5f;
+        static constexpr float MIN_SAMPLE_RATE         = 2000.f;
+        static constexpr float MAX_IMPULSE_SECONDS     = 10.f;
+        static constexpr float IMPULSE_RESPONSE_ENERGY = .5f;
+        static constexpr float LIMITER_LOOKAHEAD_MS    = 1.5f;
+        static constexpr float LIMITER_CEILING_DB      = -.3f;
+        static const int TILE_SIZE = 64; // amount of frames the effect chain processes in a single sweep
+        static const int MAX_CHANNELS = 8; // maximum amount of channels per bus
+
+        // the ranges of the sidechain gate properties
+
+        static constexpr float MIN_SIDECHAIN_ATTACK_MS     = .1f;
+        static constexpr float MAX_SIDECHAIN_ATTACK_MS     = 100.f;
+        static constexpr float MIN_SIDECHAIN_RELEASE_MS    = 5.f;
+        static constexpr float MAX_SIDECHAIN_RELEASE_MS    = 2000.f;
+        static constexpr float MIN_SIDECHAIN_THRESHOLD_DB  = -60.f;
+
+        // the available reverb algorithms, where FDN provides a denser
+        // tail at roughly the same CPU cost as the FREEVERB comb filter bank
+        // and CONVOLUTION applies a loaded impulse response (see loadImpulseResponse())
+
+        enum ReverbEngines {
+            FREEVERB,
+            FDN,
+            CONVOLUTION
+        };
+
+        // the processing quality, REALTIME keeps the CPU load low for live use while OFFLINE
+        // reads the record buffer using Hermite interpolation, oversamples the bit crusher
+        // and diffuses the input of the FREEVERB reverb for a denser tail
+
+        enum QualityModes {
+            REALTIME,
+            OFFLINE
+        };
+
+        // how the quality mode is selected, AUTOMATIC_QUALITY follows the process mode of the host
+        // (see setProcessingContext()) while the others select a quality mode regardless of it
+
+        enum QualitySelections {
+            AUTOMATIC_QUALITY,
+            REALTIME_QUALITY,
+            OFFLINE_QUALITY
+        };
+
+        // the quality tiers the deadline monitor steps down through when processing on a real-time thread
+        // comes close to exceeding its deadline (see DeadlineMonitor). Each tier includes the economies of
+        // the tiers before it, tiers that economize on nothing in the current quality and limiter mode are
+        // skipped. The governor runs whenever there is a deadline, regardless of the quality mode
+
+        enum QualityTiers {
+            FULL_QUALITY,
+            LINEAR_INTERPOLATION, // the record buffer is read without Hermite interpolation (OFFLINE only)
+            REDUCED_REVERB,       // the FREEVERB reverb runs half its comb filters (see Reverb::setEconomy())
+            NO_OVERSAMPLING       // the bit crusher (OFFLINE only) and the TRUE_PEAK limiter detection are not oversampled
+        };
+
+        // what opens and closes the gates, LFO applies the tempo synchronized gate oscillators while the
+        // SIDECHAIN modes follow the envelope (detected by peak or RMS level) of the sidechain input (or
+        // the input itself, when no sidechain is provided)
+
+        enum GateModes {
+            LFO,
+            SIDECHAIN_PEAK,
+            SIDECHAIN_RMS
+        };
+
+        // the modes of the output limiter, CLASSIC adds no latency but can overshoot on transients while
+        // the LOOKAHEAD modes delay the output to keep it below the ceiling (where TRUE_PEAK also
+        // prevents its inter-sample peaks from exceeding the ceiling)
+
+        enum LimiterModes {
+            CLASSIC,
+            LOOKAHEAD,
+            TRUE_PEAK
+        };
+
+        PluginProcess( int amountOfChannels, const ProcessingContext& context );
         ~PluginProcess();
 
-        // apply effect to incoming sampleBuffer contents
+        // apply effect to incoming sampleBuffer contents, sideChainBuffer is optional
+        // and only used when the gates follow the sidechain (see GateModes)
 
         template <typename SampleType>
         void process( SampleType** inBuffer, SampleType** outBuffer, int numInChannels, int numOutChannels,
-            int bufferSize, uint32 sampleFramesSize
+            int bufferSize, uint32 sampleFramesSize, SampleType** sideChainBuffer = nullptr, int numSideChainChannels = 0
         );
 
+        // passes the incoming sampleBuffer contents through unprocessed while bypassed. The input is delayed
+        // by the latency of process(), so toggling the bypass does not shift the timing of the signal
+
+        template <typename SampleType>
+        void bypass( SampleType** inBuffer, SampleType** outBuffer, int numInChannels, int bufferSize );
+
         // setters
 
         void setDryMix( float value );
         void setGateSpeed( float oddSteps, float evenSteps, bool linkGates );
         void randomizeGateSpeed( float randomSteps );
 
+        // sidechain gate properties, all in the normalized 0 - 1 range (where
+        // the value for the gate mode is scaled to the amount of GateModes)
+
+        void setGateMode( float value );
+        void setSideChainAttack( float value );
+        void setSideChainRelease( float value );
+        void setSideChainThreshold( float value );
+
+        // the limiter mode, in the normalized 0 - 1 range (scaled to the amount of LimiterModes)
+
+        void setLimiterMode( float value );
+        static LimiterModes toLimiterMode( float value );
+
+        // the latency (in samples) introduced by the limiter in its current mode, or for given mode at
+        // given sample rate (which can be calculated before a PluginProcess is created)
+
+        int getLatency();
+        static int calculateLatency( LimiterModes mode, float sampleRate );
+
         // others
 
         // synchronize the gate tempo with the host
@@ -79,10 +193,49 @@ class PluginProcess {
 
         void syncGates();
 
-        // assigns the appropriate WaveTables to each gate
+        // assigns the appropriate (shared) WaveTable to each gate
 
         void createGateTables( float normalizedWaveFormType );
 
+        // applies the sample rate, maximum block size and process mode of given context (the tempo
+        // is synchronized separately through setTempo()). When the sample rate changes, the
+        // sample rate dependent child processors are retuned. Unless selected explicitly, the process
+        // mode selects the quality mode (OFFLINE for offline rendering, REALTIME otherwise). This is invoked by
+        // the host upon setupProcessing (outside of the audio thread)
+
+        void setProcessingContext( const ProcessingContext& context );
+        const ProcessingContext& getProcessingContext();
+
+        // the Arena holding the state of the child processors (e.g. to verify its sizing)
+
+        Arena* getArena();
+
+        // explicitly selects the quality mode (regardless of the process mode), for instance to
+        // compare the output of both modes. The mode remains selected when the processing context
+        // changes, until the automatic selection is restored through setQualitySelection()
+
+        void setQualityMode( QualityModes mode );
+        QualityModes getQualityMode();
+
+        // selects the quality mode for given normalized 0 - 1 value (see QualitySelections), this
+        // does not allocate and can be invoked on the audio thread
+
+        void setQualitySelection( float value );
+        QualitySelections getQualitySelection();
+        static QualitySelections toQualitySelection( float value );
+
+        // the quality tier requested by the deadline monitor, can be invoked from any thread
+
+        QualityTiers getQualityTier();
+
+        // loads the impulse response for the CONVOLUTION reverb engine from a WAV file, returns
+        // false when the file could not be read. This reads from disk and allocates and should thus
+        // be invoked outside of the audio thread, the new reverbs are picked up by the next process() call
+
+        bool loadImpulseResponse( const char* path );
+        void clearImpulseResponse();
+        bool hasImpulseResponse();
+
         void resetReadWritePointers();
         void resetGates();
         void clearRecordBuffer();
@@ -91,23 +244,46 @@ class PluginProcess {
         void setPlaybackRate( float value );
         void setHarmony( float value );
         void enableReverb( bool enabled );
+        void setReverbEngine( ReverbEngines engine );
+        ReverbEngines getReverbEngine();
+
+        // the algorithmic engine (FREEVERB or FDN) for given normalized 0 - 1 value, letting the
+        // reverb engine be selected by CPU budget (CONVOLUTION requires an impulse response to be loaded)
+
+        static ReverbEngines toReverbEngine( float value );
         void enableReverse( bool enabled );
 
         // child processors
 
         BitCrusher* bitCrusher;
         Limiter* limiter;
+        Meter* meter;
+        DeadlineMonitor* deadlineMonitor; // governs the quality tier, only while processing in real-time
         Reverb* reverb;
 
+#ifdef DARVAZA_PROFILE
+        Profiler* profiler; // timings of the stages of process(), see profiler.h
+#endif
+
     private:
+        ProcessingContext _context;
         int _amountOfChannels;
-        std::vector<WaveTable*> _waveTables;
+        Arena* _arena; // holds the state of all child processors
+        std::vector<Oscillator*> _oscillators; // gate oscillators, per channel
 
-        AudioBuffer* _recordBuffer; // buffer used to record incoming signal
+        RingBuffer* _recordBuffer;  // buffer used to record incoming signal
         AudioBuffer* _preMixBuffer; // buffer used for the pre effect mixing
-        int _lastBufferSize = 0;    // size of the last buffer used when generating the _recordBuffer
+        AudioBuffer* _gateLevelBuffer = nullptr; // gate levels derived from the sidechain envelope
 
         bool _reverbEnabled = false;
+        ReverbEngines _reverbEngine = ReverbEngines::FREEVERB;
+        QualityModes _qualityMode   = QualityModes::REALTIME;
+        QualitySelections _qualitySelection = QualitySelections::AUTOMATIC_QUALITY;
+        QualityTiers _qualityTier   = QualityTiers::FULL_QUALITY;
+        QualityTiers _qualityTiers[ QualityTiers::NO_OVERSAMPLING + 1 ]; // the tiers applicable to the quality mode
+        GateModes _gateMode         = GateModes::LFO;
+        LimiterModes _limiterMode   = LimiterModes::TRUE_PEAK;
+        EnvelopeFollower* _envelopeFollower;
         float _dryMix = 0.f;
 
         bool _linkedGates      = false;
@@ -127,8 +303,7 @@ class PluginProcess {
         // speeds can be configured for these (e.g. _harmonize) the write pointer
         // will always be equal
 
-        int _writePointer        = 0;
-        int _maxRecordBufferSize = 0;
+        int _writePointer = 0;
         float* _readPointers;
 
         // cached values for sample accurate calculation of relevant musical positions
@@ -139,9 +314,8 @@ class PluginProcess {
         int _beatSamples           = 0;
         int _sixteenthSamples      = 0;
 
-        // tempo related
+        // tempo related (the tempo itself is stored in the processing context)
 
-        double _tempo             = 0.0;
         int32 _timeSigNumerator   = 0;
         int32 _timeSigDenominator = 0;
         float _fullMeasureDuration;
@@ -149,6 +323,7 @@ class PluginProcess {
         // related to playback of precorded content (when downsampling or playing at reduced speed)
 
         float* _lastSamples; // last written sample, per channel
+        float* _crushInputs; // last bit crusher input sample, per channel (used by the OFFLINE quality mode)
         float _downSampleAmount = 0.f; // 1 == no change (original sample rate), > 1 provides down sampling
         float _maxDownSample;
         float _playbackRate = MIN_PLAYBACK_SPEED; // 1 == 100% (no change), < 1 is lower playback speed
@@ -159,8 +334,45 @@ class PluginProcess {
         float _oddPitch = 1.f;
         float _evenPitch = 1.f;
 
+        // per channel lines delaying the input by the limiter latency while bypassed, these are
+        // also written while processing so the input is available as soon as bypass is enabled
+
+        double* _bypassLines   = nullptr;
+        double* _bypassScratch = nullptr;
+        int _bypassLineSize    = 0; // capacity of each line (the latency of the TRUE_PEAK mode)
+        int _bypassLatency     = 0; // current length of each line (the latency of the current mode)
+
+        // allocates the bypass lines for the current sample rate, invoked outside of the audio thread
+
+        void prepareBypassLines();
+
+        // shifts input into the line (of given length) and writes the samples leaving it into output (which can
+        // be the input buffer), when output is nullptr the input is written into the line only
+
+        template <typename SampleType>
+        void delayBypassed( double* line, int length, const SampleType* input, SampleType* output, int bufferSize );
+
         std::vector<LowPassFilter*> _lowPassFilters;
         std::vector<Reverb*> _reverbs;
+        std::vector<FDNReverb*> _fdnReverbs;
+
+        // the convolution reverbs are (re)created outside of the audio thread whenever the impulse
+        // response or sample rate changes. A new set is handed to the audio thread through _pendingConvolutionReverbs,
+        // the set it replaces is handed back through _retiredConvolutionReverbs so it can be freed outside of the audio thread
+
+        typedef std::vector<ConvolutionReverb*> ConvolutionReverbs;
+
+        ConvolutionReverbs* _convolutionReverbs = nullptr; // owned by the audio thread
+        std::atomic<ConvolutionReverbs*> _pendingConvolutionReverbs{ nullptr };
+        std::atomic<ConvolutionReverbs*> _retiredConvolutionReverbs{ nullptr };
+
+        AudioBuffer* _impulseResponse = nullptr; // impulse response as read from file
+        float _impulseResponseSampleRate = 0.f;
+
+        void createConvolutionReverbs( float sampleRate );
+        void collectConvolutionReverbs();
+        void swapConvolutionReverbs();
+        void deleteConvolutionReverbs( ConvolutionReverbs* reverbs );
 
         inline bool isSlowedDown() {
             return _playbackRate < 1.f || isHarmonized();
@@ -178,15 +390,44 @@ class PluginProcess {
             return _randomizedSpeed > 0.f;
         }
 
+        void setSampleRate( float sampleRate );
+        void calculateMeasureSamples();
         void clearGateTables();
+        void acquireGateTables( float sampleRate );
         WaveGenerator::WaveForms _gateWaveForm;
+        WaveTable* _gateTables[ WaveGenerator::AMOUNT_OF_WAVEFORMS ]; // pooled tables for each waveform
 
-        // ensures the pre- and post mix buffers match the appropriate amount of channels
-        // and buffer size. the buffers are pooled so this can be called upon each process
-        // cycle without allocation overhead
+        // ensures the record and mix buffers can hold blocks of given size (at the current sample
+        // rate), these are only recreated when too small. This allocates and is thus invoked outside
+        // of the audio thread (when constructing or changing the processing context)
 
-        template <typename SampleType>
-        void prepareMixBuffers( SampleType** inBuffer, int numInChannels, int bufferSize );
+        void prepareMixBuffers( int bufferSize );
+
+        // applies the economies of given quality tier, invoked by the audio thread
+
+        void applyQualityTier( QualityTiers tier );
+
+        // applies given quality mode to the child processors and the governed quality tiers
+
+        void applyQualityMode( QualityModes mode );
+
+        // the quality mode matching the process mode of the host
+
+        QualityModes getAutomaticQualityMode();
+
+        // collects the tiers that economize on something in the current quality and limiter mode
+
+        void updateQualityTiers();
+
+        // noise source for the dithering, a linear congruential generator (unlike rand() it
+        // maintains its state per instance and does not lock), in the 0 - DITHER_NOISE_MAX range
+
+        uint32 _ditherSeed = 22222;
+
+        inline int ditherNoise() {
+            _ditherSeed = _ditherSeed * 1664525 + 1013904223;
+            return ( int ) ( _ditherSeed >> 1 );
+        }
 };
 }
 
@@ -21,19 +21,70 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "calc.h"
+#include <string.h>
+#include <type_traits>
 
 namespace Igorski
 {
 template <typename SampleType>
 void PluginProcess::process( SampleType** inBuffer, SampleType** outBuffer, int numInChannels, int numOutChannels,
-                             int bufferSize, uint32 sampleFramesSize ) {
+                             int bufferSize, uint32 sampleFramesSize, SampleType** sideChainBuffer, int numSideChainChannels ) {
 
     if ( bufferSize <= 0 ) {
         return; // Variable Block Size unit test
     }
 
+    RT_SCOPE( "PluginProcess::process" ); // must not allocate, lock or block (see realtimecheck.h)
+
+    // the mix buffers are prepared for the maximum block size of the processing context. Should
+    // the host provide a larger block (which it shouldn't), the block is processed in slices of that
+    // size, so processing never has to allocate
+
+    int maxBufferSize = _preMixBuffer->bufferSize;
+
+    if ( bufferSize > maxBufferSize ) {
+        SampleType* inSlice[ MAX_CHANNELS ];
+        SampleType* outSlice[ MAX_CHANNELS ];
+        SampleType* sideChainSlice[ MAX_CHANNELS ];
+
+        numInChannels        = std::min( numInChannels, ( int ) MAX_CHANNELS );
+        numOutChannels       = std::min( numOutChannels, ( int ) MAX_CHANNELS );
+        numSideChainChannels = sideChainBuffer != nullptr ? std::min( numSideChainChannels, ( int ) MAX_CHANNELS ) : 0;
+
+        for ( int offset = 0; offset < bufferSize; offset += maxBufferSize ) {
+            int sliceSize = std::min( maxBufferSize, bufferSize - offset );
+
+            for ( int c = 0; c < numInChannels; ++c )        inSlice[ c ]        = inBuffer[ c ] + offset;
+            for ( int c = 0; c < numOutChannels; ++c )       outSlice[ c ]       = outBuffer[ c ] + offset;
+            for ( int c = 0; c < numSideChainChannels; ++c ) sideChainSlice[ c ] = sideChainBuffer[ c ] + offset;
+
+            process<SampleType>(
+                inSlice, outSlice, numInChannels, numOutChannels, sliceSize, ( uint32 ) ( sizeof( SampleType ) * sliceSize ),
+                numSideChainChannels > 0 ? sideChainSlice : nullptr, numSideChainChannels
+            );
+        }
+        return;
+    }
+
     ScopedNoDenormals noDenormals;
 
+    PROFILE_BEGIN_BLOCK( profiler );
+
+    // the processing time of the block is measured against its deadline, which
+    // determines the quality tier the next blocks are processed at (see DeadlineMonitor)
+
+    DeadlineMonitor::Clock::time_point processStart = DeadlineMonitor::now();
+
+    QualityTiers qualityTier = _qualityTiers[ deadlineMonitor->getTier() ];
+
+    if ( qualityTier != _qualityTier ) {
+        applyQualityTier( qualityTier );
+    }
+
+    // measure the input before processing (as the host can provide the same buffers for input and output)
+
+    meter->measureInput<SampleType>( inBuffer, numInChannels, bufferSize );
+
     // input and output buffers can be float or double as defined
     // by the templates SampleType value. Internally we process
     // audio as floats
@@ -45,43 +96,79 @@ void PluginProcess::process( SampleType** inBuffer, SampleType** outBuffer, int
     int writePointer;
     int writtenSamples;
 
-    int recordMax     = _maxRecordBufferSize - 1;
+    // when following the sidechain, derive the gate levels from its envelope before
+    // the input is processed (when no sidechain is provided, the input itself is followed)
+
+    bool followSideChain = _gateMode != GateModes::LFO;
+    float* gateLevels    = _gateLevelBuffer->getBufferForChannel( 0 );
+
+    if ( followSideChain ) {
+        if ( sideChainBuffer != nullptr && numSideChainChannels > 0 ) {
+            _envelopeFollower->process<SampleType>( sideChainBuffer, numSideChainChannels, bufferSize, gateLevels );
+        } else {
+            _envelopeFollower->process<SampleType>( inBuffer, numInChannels, bufferSize, gateLevels );
+        }
+    }
+    PROFILE_MARK( profiler, ANALYSIS );
+
+    // the record buffer is mirrored, reads and writes can exceed its size by up to its size
+    // (wrapped positions are only normalized once at the end of the block)
+
+    int recordSize    = _recordBuffer->size;
     int maxBufferPos  = bufferSize - 1;
     int maxReadOffset = _writePointer + maxBufferPos; // never read beyond the range of the current incoming input
-
-    prepareMixBuffers( inBuffer, numInChannels, bufferSize );
+    swapConvolutionReverbs();
 
     bool playFromRecordBuffer = isSlowedDown() || isDownSampled();
     bool randomizeSpeed = hasRandomizedSpeed();
     bool harmonize = isHarmonized();
+    bool useFDN = _reverbEngine == ReverbEngines::FDN;
+    bool hasConvolution = _convolutionReverbs != nullptr && !_convolutionReverbs->empty();
+    bool useConvolution = hasConvolution && _reverbEngine == ReverbEngines::CONVOLUTION;
+    bool highQuality    = _qualityMode == QualityModes::OFFLINE;
+    bool useHermite     = highQuality && _qualityTier < QualityTiers::LINEAR_INTERPOLATION;
+    bool useOversampling = highQuality && _qualityTier < QualityTiers::NO_OVERSAMPLING;
+
+    // when the host provides the same buffers for input and output (and the input is not replaced by
+    // the recorded content) the effect chain runs directly on the output buffer. As the input is
+    // overwritten in the process, the dry signal is read from its copy in the record buffer. For
+    // 64-bit samples the input is staged through the pre mix buffer (as the record buffer is 32-bit)
+
+    bool canProcessInPlace = std::is_same<SampleType, float>::value && !playFromRecordBuffer;
+    int recordOffset       = _writePointer;
+
+    _recordBuffer->prepareWrite( _writePointer, bufferSize );
 
     for ( int32 c = 0; c < numInChannels; ++c )
     {
         bool isOddChannel = ( c % 2 ) == 0;
 
         readPointer  = _readPointers[ c ];
-        writePointer = _writePointer;
+        writePointer = ( _writePointer + bufferSize ) % recordSize;
 
-        SampleType* channelInBuffer  = inBuffer[ c ];
-        SampleType* channelOutBuffer = outBuffer[ c ];
-        float* channelRecordBuffer   = _recordBuffer->getBufferForChannel( c );
-        float* channelPreMixBuffer   = _preMixBuffer->getBufferForChannel( c );
+        SampleType* channelInBuffer = inBuffer[ c ];
+        float* channelRecordBuffer  = _recordBuffer->getBufferForChannel( c );
+        float* channelRecordSpan    = channelRecordBuffer + _writePointer;
+        float* channelPreMixBuffer  = _preMixBuffer->getBufferForChannel( c );
 
-        WaveTable* table = _waveTables.at( c );
+        // 1. write incoming input into the record buffer (converting to float when necessary) and
+        // stage it in the pre mix buffer, unless processing in place or playing from the record buffer
 
-        writtenSamples = _writtenMeasureSamples;
+        for ( i = 0; i < bufferSize; ++i ) {
+            channelRecordSpan[ i ] = ( float ) channelInBuffer[ i ];
+        }
+        _recordBuffer->commit( c, _writePointer, bufferSize );
 
-        // 1. write incoming input into the record and pre mix buffers (converting to float when necessary)
+        // keep the bypass line filled, so the input continues seamlessly once bypassed
 
-        for ( i = 0; i < bufferSize; ++i, ++writePointer ) {
-            if ( writePointer > recordMax ) {
-                writePointer = 0;
-            }
-            tmpSample = ( float ) channelInBuffer[ i ];
+        delayBypassed<SampleType>( _bypassLines + c * _bypassLineSize, _bypassLatency, channelInBuffer, nullptr, bufferSize );
 
-            channelRecordBuffer[ writePointer ] = tmpSample;
-            channelPreMixBuffer[ i ]            = tmpSample;
+        bool inPlace = canProcessInPlace && ( void* ) channelInBuffer == ( void* ) outBuffer[ c ];
+
+        if ( !inPlace && !playFromRecordBuffer ) {
+            memcpy( channelPreMixBuffer, channelRecordSpan, bufferSize * sizeof( float ));
         }
+        PROFILE_MARK( profiler, RECORD );
 
         // 2. in case we should play at a custom rate from the record buffer
         // fill the pre mix buffer with the appropriate slowed down recorded content
@@ -90,7 +177,7 @@ void PluginProcess::process( SampleType** inBuffer, SampleType** outBuffer, int
 
             float nextSample, curSample, outSample;
             int r1 = 0, r2 = 0, t, t2;
-            float incr, frac, s1, s2;
+            float incr, frac, s0, s1, s2, s3, interpolated;
 
             // calculate iterator size when reading from recorded buffer
             // this is determined by the down sampling amount (defined in _fSampleIncr)
@@ -108,25 +195,43 @@ void PluginProcess::process( SampleType** inBuffer, SampleType** outBuffer, int
 
             i = 0;
             while ( i < bufferSize ) {
-                t  = ( int ) readPointer;
-                t2 = std::min( recordMax, t + _sampleIncr );
+                t = ( int ) readPointer;
+
+                if ( useHermite ) {
+                    // interpolate at the fractional read position, the samples ahead are capped to
+                    // the range of the current incoming input and the sample behind wraps into
+                    // the mirrored range of the record buffer
 
-                // this fractional is in the 0 - 1 range
+                    frac = readPointer - t;
 
-                frac = /*readPointer - t;*/ 0.f;
+                    s0 = _recordBuffer->read( c, t > 0 ? t - 1 : recordSize - 1 );
+                    s1 = _recordBuffer->read( c, t );
+                    s2 = _recordBuffer->read( c, std::min( t + 1, maxReadOffset ));
+                    s3 = _recordBuffer->read( c, std::min( t + 2, maxReadOffset ));
 
-                s1 = channelRecordBuffer[ t ];
-                s2 = channelRecordBuffer[ t2 ];
+                    interpolated = Calc::hermite( s0, s1, s2, s3, frac );
+                } else {
+                    t2 = t + _sampleIncr;
+
+                    // this fractional is in the 0 - 1 range
+
+                    frac = /*readPointer - t;*/ 0.f;
+
+                    s1 = _recordBuffer->read( c, t );
+                    s2 = _recordBuffer->read( c, t2 );
+
+                    interpolated = s1 + ( s2 - s1 ) * frac;
+                }
 
                 // we apply a lowpass filter to prevent interpolation artefacts
 
-                curSample = lowPassFilter->applySingle( s1 + ( s2 - s1 ) * frac );
+                curSample = lowPassFilter->applySingle( interpolated );
                 outSample = curSample * .5f;
 
                 int start = i;
                 for ( int32 l = std::min( bufferSize, start + _sampleIncr ); i < l; ++i ) {
                     r2 = r1;
-                    r1 = rand();
+                    r1 = ditherNoise();
 
                     nextSample = outSample + lastSample;
                     lastSample = nextSample * .25f;
@@ -148,115 +253,207 @@ void PluginProcess::process( SampleType** inBuffer, SampleType** outBuffer, int
                 }
             }
             _lastSamples[ c ] = lastSample;
+
+            PROFILE_MARK( profiler, PLAYBACK );
         }
 
-        // 3. run the pre mix effects that require no sample accurate property updates
+        // end of input stage for channel
 
-        bitCrusher->process( channelPreMixBuffer, bufferSize );
+        // update read index (wrapping it back into the range of the record buffer)
 
-        // 4. apply gate and mix the input and processed mix buffer into the output buffer
+        if ( readPointer >= recordSize ) {
+            readPointer -= recordSize;
+        }
+        _readPointers[ c ] = readPointer;
+    }
 
-        Reverb* reverb = _reverbs.at( c );
+    // update write index
 
-        for ( i = 0; i < bufferSize; ++i ) {
+    _writePointer  = writePointer;
+    writtenSamples = _writtenMeasureSamples;
+
+    // 3. run the effect chain (bitcrush, reverb, gate, dry mix, clip and limiter) in a single
+    // sweep over small tiles of all channels, so each tile remains in the cache for the entire chain
+    // (the gain reduction is metered over all tiles of the block)
 
-            // increment the written sample amount to keep track of key positions
-            // within the current measure to align the gates to
+    limiter->resetGainReduction();
 
-            if ( ++writtenSamples >= _fullMeasureSamples ) {
-                writtenSamples = 0; // new measure
+    for ( int32 offset = 0; offset < bufferSize; offset += TILE_SIZE )
+    {
+        int32 tileEnd = std::min( bufferSize, offset + TILE_SIZE );
+        int32 tileWrittenSamples = writtenSamples;
+
+        for ( int32 c = 0; c < numInChannels; ++c )
+        {
+            bool isOddChannel = ( c % 2 ) == 0;
+
+            SampleType* channelInBuffer  = inBuffer[ c ];
+            SampleType* channelOutBuffer = outBuffer[ c ];
+
+            // the wet signal is processed in the output buffer when processing in place
+            // (in which case the dry signal is read from the record buffer)
+
+            bool inPlace           = canProcessInPlace && ( void* ) channelInBuffer == ( void* ) channelOutBuffer;
+            float* channelWetBuffer = inPlace ? ( float* ) channelOutBuffer : _preMixBuffer->getBufferForChannel( c );
+            float* channelDryBuffer = _recordBuffer->getBufferForChannel( c ) + recordOffset;
+
+            Oscillator* gate = _oscillators.at( c );
+
+            // each channel walks the same musical positions within the tile
+
+            tileWrittenSamples = writtenSamples;
+
+            // 3.1. run the pre mix effects that require no sample accurate property updates
+
+            if ( useOversampling ) {
+                bitCrusher->processOversampled( channelWetBuffer + offset, tileEnd - offset, _crushInputs[ c ] );
+            } else {
+                bitCrusher->process( channelWetBuffer + offset, tileEnd - offset );
             }
+            PROFILE_MARK( profiler, BITCRUSHER );
+
+            // 3.2. run the reverb on the processed mix buffer
 
-            // if gate speed inversion is enabled, count the progress
-            // and advance the speeds every half measure
+            Reverb* reverb = _reverbs.at( c );
+            FDNReverb* fdnReverb = _fdnReverbs.at( c );
+            ConvolutionReverb* convolutionReverb = hasConvolution ? _convolutionReverbs->at( c ) : nullptr;
 
-            if ( randomizeSpeed ) {
-                if ( isOddChannel && ( ++_oddInvertProg >= _halfMeasureSamples )) {
-                    _oddInvertProg = 0;
-                    setOddGateSpeed( _curOddSteps == _oddSteps ? _randomizedSpeed : _oddSteps );
-                } else if ( !isOddChannel && ( ++_evenInvertProg >= _halfMeasureSamples )) {
-                    _evenInvertProg = 0;
-                    setEvenGateSpeed( _curEvenSteps == _evenSteps ? _randomizedSpeed : _evenSteps );
+            for ( i = offset; i < tileEnd; ++i ) {
+
+                // increment the written sample amount to keep track of key positions
+                // within the current measure to align the gates to
+
+                if ( ++tileWrittenSamples >= _fullMeasureSamples ) {
+                    tileWrittenSamples = 0; // new measure
                 }
-            }
 
-            // run sample accurate property updates
+                // run sample accurate property updates
+
+                if (( tileWrittenSamples % _beatSamples ) == 0 ) {
+                    // a beat has passed
+                    if ( c == 0 ) {
+                        // global parameters (gate speed, etc.) should only be toggled once per loop
+                        //setGateSpeed( writtenSamples == 0 ? 0.5f : 0.1f, writtenSamples == 0 ? 0.5f : 0.1f );
+                    }
+                    // all engines toggle so their freeze states remain in phase when switching
+
+                    reverb->toggleFreeze();
+                    fdnReverb->toggleFreeze();
 
-            if (( writtenSamples % _beatSamples ) == 0 ) {
-                // a beat has passed
-                if ( c == 0 ) {
-                    // global parameters (gate speed, etc.) should only be toggled once per loop
-                    //setGateSpeed( writtenSamples == 0 ? 0.5f : 0.1f, writtenSamples == 0 ? 0.5f : 0.1f );
+                    if ( convolutionReverb != nullptr ) {
+                        convolutionReverb->toggleFreeze();
+                    }
+                }
+
+                if ( _reverbEnabled ) {
+                    if ( useConvolution ) {
+                        channelWetBuffer[ i ] = convolutionReverb->processSingle( channelWetBuffer[ i ] );
+                    } else {
+                        channelWetBuffer[ i ] = useFDN ? fdnReverb->processSingle( channelWetBuffer[ i ] ) : reverb->processSingle( channelWetBuffer[ i ] );
+                    }
                 }
-                reverb->toggleFreeze();
             }
+            PROFILE_MARK( profiler, REVERB );
 
-            // open / close the gate
-            // note we multiply by .5 and add .5 to make the LFO's bipolar waveform unipolar
+            // 3.3. apply gate and mix the input and processed mix buffer into the output buffer
 
-            SampleType gateLevel = ( SampleType ) ( table->peek() * .5f + .5f );
+            for ( i = offset; i < tileEnd; ++i ) {
 
-            tmpSample = channelPreMixBuffer[ i ];
+                // if gate speed inversion is enabled, count the progress
+                // and advance the speeds every half measure
 
-            // run the pre mix effects that require sample accurate property updates
+                if ( randomizeSpeed ) {
+                    if ( isOddChannel && ( ++_oddInvertProg >= _halfMeasureSamples )) {
+                        _oddInvertProg = 0;
+                        setOddGateSpeed( _curOddSteps == _oddSteps ? _randomizedSpeed : _oddSteps );
+                    } else if ( !isOddChannel && ( ++_evenInvertProg >= _halfMeasureSamples )) {
+                        _evenInvertProg = 0;
+                        setEvenGateSpeed( _curEvenSteps == _evenSteps ? _randomizedSpeed : _evenSteps );
+                    }
+                }
 
-            if ( _reverbEnabled ) {
-                tmpSample = reverb->processSingle( tmpSample );
-            }
+                // open / close the gate
+                // note we multiply by .5 and add .5 to make the LFO's bipolar waveform unipolar
+                // (the LFO keeps running while following the sidechain, so it remains in phase)
+
+                SampleType gateLevel = ( SampleType ) ( gate->peek() * .5f + .5f );
+
+                if ( followSideChain ) {
+                    gateLevel = ( SampleType ) gateLevels[ i ];
+                }
+
+                // read both signals before writing the output (which can be the input buffer)
 
-            // blend in the effect mix buffer for the gates value
+                tmpSample = channelWetBuffer[ i ];
+                SampleType drySample = inPlace ? ( SampleType ) channelDryBuffer[ i ] : channelInBuffer[ i ];
 
-            channelOutBuffer[ i ] = Calc::capSample(( SampleType ) ( tmpSample ) * gateLevel );
+                // blend in the effect mix buffer for the gates value and
+                // the dry signal (mixed to the negative of the gated signal)
 
-            // blend in the dry signal (mixed to the negative of the gated signal)
-            channelOutBuffer[ i ] += (( channelInBuffer[ i ] * ( 1.0 - gateLevel )) * dryMix );
+                channelOutBuffer[ i ] = Calc::capSample(( SampleType ) ( tmpSample ) * gateLevel ) +
+                                        (( drySample * ( 1.0 - gateLevel )) * dryMix );
+            }
+            PROFILE_MARK( profiler, GATE );
         }
-        // end of processing for channel
+        writtenSamples = tileWrittenSamples;
 
-        // update read index
-        _readPointers[ c ] = readPointer;
-    }
+        // 3.4. limit the output signal of the tile in case its gets hot
 
-    // update write indices
+        limiter->process<SampleType>( outBuffer, tileEnd - offset, numOutChannels, offset );
+
+        PROFILE_MARK( profiler, LIMITER );
+    }
 
-    _writePointer          = writePointer;
     _writtenMeasureSamples = writtenSamples;
 
-    // limit the output signal in case its gets hot
-    limiter->process<SampleType>( outBuffer, bufferSize, numOutChannels );
+    meter->measureOutput<SampleType>( outBuffer, numOutChannels, bufferSize );
+    meter->measureGainReduction( limiter->getLinearGR() );
+    meter->update( bufferSize );
+
+    PROFILE_MARK( profiler, ANALYSIS );
+    PROFILE_END_BLOCK( profiler, bufferSize );
+
+    deadlineMonitor->measure( processStart, bufferSize );
 }
 
 template <typename SampleType>
-void PluginProcess::prepareMixBuffers( SampleType** inBuffer, int numInChannels, int bufferSize )
-{
-    // variable block size for a smaller block should not require new record buffers
-    // only create these when the last size was smaller than the current
-    if ( bufferSize <= _lastBufferSize ) {
-        return;
+void PluginProcess::bypass( SampleType** inBuffer, SampleType** outBuffer, int numInChannels, int bufferSize ) {
+
+    RT_SCOPE( "PluginProcess::bypass" );
+
+    for ( int32 c = 0; c < numInChannels; ++c ) {
+        if ( c < _amountOfChannels ) {
+            delayBypassed<SampleType>( _bypassLines + c * _bypassLineSize, _bypassLatency, inBuffer[ c ], outBuffer[ c ], bufferSize );
+        } else if ( inBuffer[ c ] != outBuffer[ c ]) {
+            memcpy( outBuffer[ c ], inBuffer[ c ], bufferSize * sizeof( SampleType ));
+        }
     }
+}
 
-    _lastBufferSize = bufferSize;
+template <typename SampleType>
+void PluginProcess::delayBypassed( double* line, int length, const SampleType* input, SampleType* output, int bufferSize ) {
 
-    // if the record buffer wasn't created yet or the buffer size has changed
-    // delete existing buffer and create new one to match properties
+    int kept = std::min( bufferSize, length ); // amount of input samples that end up in the line
 
-    int idealRecordSize = Calc::secondsToBuffer( MAX_RECORD_SECONDS );
-    int recordSize      = idealRecordSize + idealRecordSize % bufferSize;
+    // store the end of the input before writing the output (as this can overwrite the input)
 
-    if ( _recordBuffer == nullptr || _recordBuffer->bufferSize != recordSize ) {
-        delete _recordBuffer;
-        _recordBuffer = new AudioBuffer( numInChannels, recordSize );
-        _maxRecordBufferSize = recordSize;
-        resetReadWritePointers();
+    for ( int32 i = 0; i < kept; ++i ) {
+        _bypassScratch[ i ] = ( double ) input[ bufferSize - kept + i ];
     }
 
-    // if the pre mix buffer wasn't created yet or the buffer size has changed
-    // delete existing buffer and create new one to match properties
+    if ( output != nullptr ) {
+        // the input that passes the line entirely is shifted by its length (iterating backwards, as the output can
+        // overlap the input) and is preceded by the samples leaving the line
 
-    if ( _preMixBuffer == nullptr || _preMixBuffer->bufferSize != bufferSize ) {
-        delete _preMixBuffer;
-        _preMixBuffer = new AudioBuffer( numInChannels, bufferSize );
+        for ( int32 i = bufferSize - 1; i >= length; --i ) {
+            output[ i ] = input[ i - length ];
+        }
+        for ( int32 i = 0; i < kept; ++i ) {
+            output[ i ] = ( SampleType ) line[ i ];
+        }
     }
+    memmove( line, line + kept, ( length - kept ) * sizeof( double ));
+    memcpy( line + length - kept, _bypassScratch, kept * sizeof( double ));
 }
 
 }
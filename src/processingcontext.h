@@ -0,0 +1,48 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __PROCESSINGCONTEXT_H_INCLUDED__
+#define __PROCESSINGCONTEXT_H_INCLUDED__
+
+#include "global.h"
+
+using namespace Steinberg;
+
+namespace Igorski {
+
+/**
+ * ProcessingContext describes the environment a single plugin instance processes
+ * audio in. Each instance maintains its own context (rather than relying on process
+ * wide globals) so instances running at different rates within the same host process
+ * don't affect each other. The context is handed to the PluginProcess, which passes the
+ * relevant properties on to its child processors
+ */
+struct ProcessingContext
+{
+    float  sampleRate   = 44100.f;
+    int32  maxBlockSize = 1024;  // maximum amount of samples per process call
+    double tempo        = 120.0; // in BPM, as provided by the host during processing
+    int32  processMode  = 0;     // one of Vst::ProcessModes (0 = realtime, 1 = prefetch, 2 = offline)
+};
+}
+
+#endif
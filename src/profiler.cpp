@@ -0,0 +1,210 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifdef DARVAZA_PROFILE
+
+#include "profiler.h"
+#include "realtimecheck.h"
+#include <algorithm>
+#include <stdio.h>
+
+namespace Igorski {
+
+const char* Profiler::STAGE_NAMES[ Profiler::AMOUNT_OF_STAGES ] = {
+    "analysis", "record", "playback", "bitcrusher", "reverb", "gate", "limiter"
+};
+
+/* constructor */
+
+Profiler::Profiler() : _epoch( std::chrono::steady_clock::now() ), _ring( RING_SIZE )
+{
+    beginBlock();
+}
+
+/* public methods */
+
+void Profiler::endBlock( int bufferSize )
+{
+    uint32_t writeIndex = _writeIndex.load( std::memory_order_relaxed );
+
+    if ( writeIndex - _readIndex.load( std::memory_order_acquire ) >= ( uint32_t ) RING_SIZE ) {
+        _droppedBlocks.fetch_add( 1, std::memory_order_relaxed );
+        return;
+    }
+
+    Block& block     = _ring[ writeIndex % RING_SIZE ];
+    block.start      = _blockStart;
+    block.bufferSize = bufferSize;
+
+    for ( int i = 0; i < AMOUNT_OF_STAGES; ++i ) {
+        block.stageTimes[ i ] = ( int32_t ) _stageTimes[ i ];
+    }
+    _writeIndex.store( writeIndex + 1, std::memory_order_release );
+}
+
+void Profiler::collect()
+{
+    RT_ASSERT_NOT_REALTIME( "Profiler::collect()" );
+
+    std::lock_guard<std::mutex> guard( _lock );
+
+    uint32_t readIndex  = _readIndex.load( std::memory_order_relaxed );
+    uint32_t writeIndex = _writeIndex.load( std::memory_order_acquire );
+
+    for ( ; readIndex != writeIndex; ++readIndex ) {
+        collectBlock( _ring[ readIndex % RING_SIZE ]);
+    }
+    _readIndex.store( readIndex, std::memory_order_release );
+}
+
+Profiler::Statistics Profiler::readStatistics()
+{
+    collect();
+
+    std::lock_guard<std::mutex> guard( _lock );
+
+    Statistics statistics   = _statistics;
+    statistics.droppedBlocks = _droppedBlocks.exchange( 0, std::memory_order_relaxed );
+
+    if ( statistics.blocks > 0 ) {
+        statistics.meanBufferSize = ( float ) ( _bufferSizeSum / statistics.blocks );
+        statistics.meanBlockTime  = ( float ) ( _blockTimeSum / statistics.blocks );
+
+        for ( int i = 0; i < AMOUNT_OF_STAGES; ++i ) {
+            statistics.meanStageTimes[ i ] = ( float ) ( _stageTimeSums[ i ] / statistics.blocks );
+        }
+    }
+
+    // start accumulating anew
+
+    _statistics    = Statistics();
+    _bufferSizeSum = 0.0;
+    _blockTimeSum  = 0.0;
+
+    for ( int i = 0; i < AMOUNT_OF_STAGES; ++i ) {
+        _stageTimeSums[ i ] = 0.0;
+    }
+    return statistics;
+}
+
+void Profiler::setTraceRecording( bool enabled )
+{
+    std::lock_guard<std::mutex> guard( _lock );
+
+    _traceRecording = enabled;
+
+    if ( !enabled ) {
+        _trace.clear();
+    }
+}
+
+bool Profiler::isTraceRecording()
+{
+    std::lock_guard<std::mutex> guard( _lock );
+
+    return _traceRecording;
+}
+
+bool Profiler::writeChromeTrace( const std::string& path )
+{
+    collect();
+
+    std::lock_guard<std::mutex> guard( _lock );
+
+    if ( _trace.empty()) {
+        return false;
+    }
+
+    FILE* file = fopen( path.c_str(), "w" );
+
+    if ( file == nullptr ) {
+        return false;
+    }
+
+    // each block is a complete ("X") event in microseconds. As the stages of the effect chain run
+    // per tile, their accumulated times are laid out consecutively within the duration of their block
+
+    fprintf( file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n" );
+
+    for ( size_t b = 0; b < _trace.size(); ++b ) {
+        const Block& block = _trace[ b ];
+
+        int64_t blockTime = 0;
+        for ( int i = 0; i < AMOUNT_OF_STAGES; ++i ) {
+            blockTime += block.stageTimes[ i ];
+        }
+
+        fprintf( file, "%s{\"name\":\"process\",\"cat\":\"block\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"bufferSize\":%d}}",
+                 b > 0 ? ",\n" : "", block.start / 1000.0, blockTime / 1000.0, block.bufferSize );
+
+        int64_t stageStart = block.start;
+
+        for ( int i = 0; i < AMOUNT_OF_STAGES; ++i ) {
+            if ( block.stageTimes[ i ] <= 0 ) {
+                continue;
+            }
+            fprintf( file, ",\n{\"name\":\"%s\",\"cat\":\"stage\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                     STAGE_NAMES[ i ], stageStart / 1000.0, block.stageTimes[ i ] / 1000.0 );
+
+            stageStart += block.stageTimes[ i ];
+        }
+    }
+    fprintf( file, "\n]}\n" );
+
+    bool written = ferror( file ) == 0;
+    fclose( file );
+
+    _trace.clear();
+
+    return written;
+}
+
+/* private methods */
+
+void Profiler::collectBlock( const Block& block )
+{
+    if ( _traceRecording ) {
+        _trace.push_back( block );
+    }
+
+    // statistics are in microseconds
+
+    float blockTime = 0.f;
+
+    for ( int i = 0; i < AMOUNT_OF_STAGES; ++i ) {
+        float stageTime = block.stageTimes[ i ] / 1000.f;
+
+        _stageTimeSums[ i ] += stageTime;
+        _statistics.maxStageTimes[ i ] = std::max( _statistics.maxStageTimes[ i ], stageTime );
+
+        blockTime += stageTime;
+    }
+
+    ++_statistics.blocks;
+    _bufferSizeSum += block.bufferSize;
+    _blockTimeSum  += blockTime;
+    _statistics.maxBlockTime = std::max( _statistics.maxBlockTime, blockTime );
+}
+
+}
+
+#endif
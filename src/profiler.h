@@ -0,0 +1,175 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __PROFILER_H_INCLUDED__
+#define __PROFILER_H_INCLUDED__
+
+/**
+ * Low overhead timing of the stages of PluginProcess::process(), enabled by compiling with
+ * DARVAZA_PROFILE defined (see CMakeLists.txt). The audio thread attributes the time passed since
+ * its previous mark to a stage and pushes the accumulated stage timings of each processed block
+ * into a lock-free ring. Outside of the audio thread the ring is collected into statistics (which
+ * the controller requests over IMessage, see Darvaza::notify()) and optionally into a trace that
+ * can be written as Chrome trace JSON (viewable in chrome://tracing or Perfetto).
+ * When DARVAZA_PROFILE is not defined, the macros below compile to nothing.
+ */
+#ifdef DARVAZA_PROFILE
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace Igorski {
+
+class Profiler
+{
+    public:
+        // the stages of PluginProcess::process() (in order of execution, though the stages
+        // of the effect chain are executed repeatedly per tile of the block)
+
+        enum Stages {
+            ANALYSIS,   // metering and sidechain envelope detection
+            RECORD,     // writing the input into the record buffer
+            PLAYBACK,   // resampled playback from the record buffer
+            BITCRUSHER,
+            REVERB,
+            GATE,       // gate and dry/wet mix
+            LIMITER,
+            AMOUNT_OF_STAGES
+        };
+
+        static const char* STAGE_NAMES[ AMOUNT_OF_STAGES ];
+
+        static const int RING_SIZE = 8192; // amount of blocks the ring can hold before it is collected
+
+        // the timings of a single processed block, in nanoseconds
+
+        struct Block {
+            int64_t start; // relative to the construction of the Profiler
+            int32_t bufferSize;
+            int32_t stageTimes[ AMOUNT_OF_STAGES ];
+        };
+
+        // the timings of all blocks collected since the previous read, in microseconds per block
+
+        struct Statistics {
+            int   blocks         = 0;
+            int   droppedBlocks  = 0; // blocks that did not fit in the ring
+            float meanBufferSize = 0.f;
+            float meanBlockTime  = 0.f;
+            float maxBlockTime   = 0.f;
+            float meanStageTimes[ AMOUNT_OF_STAGES ] = {};
+            float maxStageTimes[ AMOUNT_OF_STAGES ]  = {};
+        };
+
+        Profiler();
+
+        // to be invoked by the audio thread at the start of a block, for every completed stage
+        // (attributing the time passed since the previous mark to given stage) and at the end of a block
+
+        inline void beginBlock() {
+            _blockStart = _lap = now();
+
+            for ( int i = 0; i < AMOUNT_OF_STAGES; ++i ) {
+                _stageTimes[ i ] = 0;
+            }
+        }
+
+        inline void mark( Stages stage ) {
+            int64_t time = now();
+            _stageTimes[ stage ] += time - _lap;
+            _lap = time;
+        }
+
+        void endBlock( int bufferSize );
+
+        // collects the blocks pushed by the audio thread, this is invoked when reading the statistics
+        // but should also be invoked regularly when processing faster than real-time (e.g. when
+        // rendering offline while recording a trace), as blocks are dropped once the ring is full
+
+        void collect();
+
+        // collects and returns the statistics of all blocks since the previous read
+
+        Statistics readStatistics();
+
+        // when recording a trace, all collected blocks are retained until the trace is written
+
+        void setTraceRecording( bool enabled );
+        bool isTraceRecording();
+
+        // collects and writes the recorded trace as Chrome trace JSON, the trace is cleared
+        // after writing. Returns false when there was nothing to write or the file could not be written
+
+        bool writeChromeTrace( const std::string& path );
+
+    private:
+        std::chrono::steady_clock::time_point _epoch;
+
+        inline int64_t now() {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - _epoch ).count();
+        }
+
+        // audio thread state
+
+        int64_t _blockStart = 0;
+        int64_t _lap        = 0;
+        int64_t _stageTimes[ AMOUNT_OF_STAGES ];
+
+        // single producer (audio thread) single consumer ring
+
+        std::vector<Block> _ring;
+        std::atomic<uint32_t> _writeIndex{ 0 };
+        std::atomic<uint32_t> _readIndex{ 0 };
+        std::atomic<int> _droppedBlocks{ 0 };
+
+        // collected state, guarded by the lock as collection can occur from multiple non-audio threads
+
+        std::mutex _lock;
+        bool _traceRecording = false;
+        std::vector<Block> _trace;
+
+        Statistics _statistics;
+        double _bufferSizeSum = 0.0;
+        double _blockTimeSum  = 0.0;
+        double _stageTimeSums[ AMOUNT_OF_STAGES ] = {};
+
+        void collectBlock( const Block& block );
+};
+}
+
+#define PROFILE_BEGIN_BLOCK( profiler ) ( profiler )->beginBlock()
+#define PROFILE_MARK( profiler, stage ) ( profiler )->mark( Igorski::Profiler::stage )
+#define PROFILE_END_BLOCK( profiler, bufferSize ) ( profiler )->endBlock( bufferSize )
+
+#else
+
+#define PROFILE_BEGIN_BLOCK( profiler )
+#define PROFILE_MARK( profiler, stage )
+#define PROFILE_END_BLOCK( profiler, bufferSize )
+
+#endif
+
+#endif
@@ -0,0 +1,309 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifdef DARVAZA_RT_CHECK
+
+#undef _FORTIFY_SOURCE // the interposed functions below must not be replaced by their fortified variants
+
+#include "realtimecheck.h"
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+#include <execinfo.h>
+#include <unistd.h>
+#define RT_CHECK_BACKTRACE
+#endif
+
+#if defined( __linux__ ) && defined( __GLIBC__ )
+#include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <time.h>
+#define RT_CHECK_INTERPOSE
+#define RT_CHECK_TLS __attribute__(( tls_model( "initial-exec" ))) // static TLS, accessing it must not allocate
+#else
+#define RT_CHECK_TLS
+#endif
+
+namespace Igorski {
+namespace RealtimeCheck {
+
+    // name of the realtime scope the current thread is in (nullptr when not in a realtime scope)
+
+    static thread_local const char* scopeName RT_CHECK_TLS = nullptr;
+
+    static void fail( const char* operation )
+    {
+        const char* name = scopeName;
+        scopeName = nullptr; // reporting the violation can allocate by itself
+
+        fprintf( stderr, "[Darvaza] real-time violation: %s within %s\n", operation, name );
+#ifdef RT_CHECK_BACKTRACE
+        void* frames[ 64 ];
+        int amountOfFrames = backtrace( frames, 64 );
+        backtrace_symbols_fd( frames, amountOfFrames, STDERR_FILENO );
+#endif
+        abort();
+    }
+
+    Scope::Scope( const char* name ) : _previousName( scopeName )
+    {
+        scopeName = name;
+    }
+
+    Scope::~Scope()
+    {
+        scopeName = _previousName;
+    }
+
+    bool isRealtime()
+    {
+        return scopeName != nullptr;
+    }
+
+    void assertNotRealtime( const char* operation )
+    {
+        if ( scopeName != nullptr ) {
+            fail( operation );
+        }
+    }
+}
+}
+
+using Igorski::RealtimeCheck::assertNotRealtime;
+
+/* allocation through operator new and delete (all platforms) */
+
+void* operator new( std::size_t size )
+{
+    assertNotRealtime( "operator new" );
+    void* memory = malloc( size > 0 ? size : 1 );
+    if ( memory == nullptr ) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[]( std::size_t size )
+{
+    assertNotRealtime( "operator new[]" );
+    void* memory = malloc( size > 0 ? size : 1 );
+    if ( memory == nullptr ) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new( std::size_t size, const std::nothrow_t& ) noexcept
+{
+    assertNotRealtime( "operator new" );
+    return malloc( size > 0 ? size : 1 );
+}
+
+void* operator new[]( std::size_t size, const std::nothrow_t& ) noexcept
+{
+    assertNotRealtime( "operator new[]" );
+    return malloc( size > 0 ? size : 1 );
+}
+
+void operator delete( void* memory ) noexcept
+{
+    if ( memory != nullptr ) {
+        assertNotRealtime( "operator delete" );
+    }
+    free( memory );
+}
+
+void operator delete[]( void* memory ) noexcept
+{
+    if ( memory != nullptr ) {
+        assertNotRealtime( "operator delete[]" );
+    }
+    free( memory );
+}
+
+void operator delete( void* memory, std::size_t ) noexcept
+{
+    operator delete( memory );
+}
+
+void operator delete[]( void* memory, std::size_t ) noexcept
+{
+    operator delete[]( memory );
+}
+
+void operator delete( void* memory, const std::nothrow_t& ) noexcept
+{
+    operator delete( memory );
+}
+
+void operator delete[]( void* memory, const std::nothrow_t& ) noexcept
+{
+    operator delete[]( memory );
+}
+
+#ifdef RT_CHECK_INTERPOSE
+
+/* the malloc family, mutexes, file access and sleeping calls (Linux) */
+
+extern "C" {
+
+void* __libc_malloc( size_t size );
+void* __libc_calloc( size_t amount, size_t size );
+void* __libc_realloc( void* memory, size_t size );
+void* __libc_memalign( size_t alignment, size_t size );
+void  __libc_free( void* memory );
+
+// the original implementation of an interposed function, resolved upon first use
+
+typedef int     ( *MutexFunction )( pthread_mutex_t* );
+typedef int     ( *ConditionWaitFunction )( pthread_cond_t*, pthread_mutex_t* );
+typedef int     ( *OpenFunction )( const char*, int, ... );
+typedef FILE*   ( *FileOpenFunction )( const char*, const char* );
+typedef ssize_t ( *ReadFunction )( int, void*, size_t );
+typedef ssize_t ( *WriteFunction )( int, const void*, size_t );
+typedef int     ( *NanoSleepFunction )( const struct timespec*, struct timespec* );
+typedef int     ( *MicroSleepFunction )( useconds_t );
+
+#define RT_CHECK_NEXT( name, type ) \
+    static type original = nullptr; \
+    if ( original == nullptr ) original = ( type ) dlsym( RTLD_NEXT, name );
+
+void* malloc( size_t size ) noexcept
+{
+    assertNotRealtime( "malloc" );
+    return __libc_malloc( size );
+}
+
+void* calloc( size_t amount, size_t size ) noexcept
+{
+    assertNotRealtime( "calloc" );
+    return __libc_calloc( amount, size );
+}
+
+void* realloc( void* memory, size_t size ) noexcept
+{
+    assertNotRealtime( "realloc" );
+    return __libc_realloc( memory, size );
+}
+
+void* aligned_alloc( size_t alignment, size_t size ) noexcept
+{
+    assertNotRealtime( "aligned_alloc" );
+    return __libc_memalign( alignment, size );
+}
+
+int posix_memalign( void** memory, size_t alignment, size_t size ) noexcept
+{
+    assertNotRealtime( "posix_memalign" );
+    *memory = __libc_memalign( alignment, size );
+    return *memory != nullptr ? 0 : ENOMEM;
+}
+
+void free( void* memory ) noexcept
+{
+    if ( memory != nullptr ) {
+        assertNotRealtime( "free" );
+    }
+    __libc_free( memory );
+}
+
+int pthread_mutex_lock( pthread_mutex_t* mutex ) noexcept
+{
+    assertNotRealtime( "pthread_mutex_lock" );
+    RT_CHECK_NEXT( "pthread_mutex_lock", MutexFunction);
+    return original( mutex );
+}
+
+int pthread_mutex_trylock( pthread_mutex_t* mutex ) noexcept
+{
+    assertNotRealtime( "pthread_mutex_trylock" );
+    RT_CHECK_NEXT( "pthread_mutex_trylock", MutexFunction);
+    return original( mutex );
+}
+
+int pthread_cond_wait( pthread_cond_t* condition, pthread_mutex_t* mutex )
+{
+    assertNotRealtime( "pthread_cond_wait" );
+    RT_CHECK_NEXT( "pthread_cond_wait", ConditionWaitFunction);
+    return original( condition, mutex );
+}
+
+int open( const char* path, int flags, ... )
+{
+    assertNotRealtime( "open" );
+    RT_CHECK_NEXT( "open", OpenFunction);
+
+    mode_t mode = 0;
+    if ( flags & O_CREAT ) {
+        va_list arguments;
+        va_start( arguments, flags );
+        mode = va_arg( arguments, mode_t );
+        va_end( arguments );
+    }
+    return original( path, flags, mode );
+}
+
+FILE* fopen( const char* path, const char* mode )
+{
+    assertNotRealtime( "fopen" );
+    RT_CHECK_NEXT( "fopen", FileOpenFunction);
+    return original( path, mode );
+}
+
+ssize_t read( int descriptor, void* buffer, size_t size )
+{
+    assertNotRealtime( "read" );
+    RT_CHECK_NEXT( "read", ReadFunction);
+    return original( descriptor, buffer, size );
+}
+
+ssize_t write( int descriptor, const void* buffer, size_t size )
+{
+    assertNotRealtime( "write" );
+    RT_CHECK_NEXT( "write", WriteFunction);
+    return original( descriptor, buffer, size );
+}
+
+int nanosleep( const struct timespec* duration, struct timespec* remaining )
+{
+    assertNotRealtime( "nanosleep" );
+    RT_CHECK_NEXT( "nanosleep", NanoSleepFunction);
+    return original( duration, remaining );
+}
+
+int usleep( useconds_t duration )
+{
+    assertNotRealtime( "usleep" );
+    RT_CHECK_NEXT( "usleep", MicroSleepFunction);
+    return original( duration );
+}
+
+}
+
+#endif
+
+#endif
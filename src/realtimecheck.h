@@ -0,0 +1,73 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __REALTIMECHECK_H_INCLUDED__
+#define __REALTIMECHECK_H_INCLUDED__
+
+/**
+ * Debugging aid verifying the real-time safety of the audio thread, enabled by
+ * compiling with DARVAZA_RT_CHECK defined (see CMakeLists.txt). While a thread is inside
+ * a realtime scope (e.g. during PluginProcess::process()) any memory allocation or release,
+ * mutex operation or blocking system call aborts the process with a stack trace.
+ *
+ * Allocations through operator new and delete are intercepted on all platforms. On Linux the
+ * malloc family, pthread mutexes, file access and sleeping calls are intercepted as well, on
+ * other platforms code that locks or performs I/O asserts it is not running in a realtime
+ * scope explicitly (see RT_ASSERT_NOT_REALTIME). When DARVAZA_RT_CHECK is not defined,
+ * the macros below compile to nothing.
+ */
+#ifdef DARVAZA_RT_CHECK
+
+namespace Igorski {
+namespace RealtimeCheck {
+
+    // marks the current thread as real-time for the lifetime of the Scope, scopes can be nested
+
+    class Scope
+    {
+        public:
+            Scope( const char* name );
+            ~Scope();
+
+        private:
+            const char* _previousName;
+    };
+
+    bool isRealtime();
+
+    // aborts with a stack trace when invoked from within a realtime scope
+
+    void assertNotRealtime( const char* operation );
+}
+}
+
+#define RT_SCOPE( name ) Igorski::RealtimeCheck::Scope rtScope__( name )
+#define RT_ASSERT_NOT_REALTIME( operation ) Igorski::RealtimeCheck::assertNotRealtime( operation )
+
+#else
+
+#define RT_SCOPE( name )
+#define RT_ASSERT_NOT_REALTIME( operation )
+
+#endif
+
+#endif
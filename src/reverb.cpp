@@ -26,7 +26,11 @@
 
 namespace Igorski {
 
-Reverb::Reverb() {
+Reverb::Reverb( float sampleRate, float* lineMemory ) {
+    _sampleRate     = sampleRate;
+    _ownsLineMemory = lineMemory == nullptr;
+    _lineMemory     = lineMemory;
+
     setupFilters();
 
     setWet     ( INITIAL_WET );
@@ -60,11 +64,15 @@ void Reverb::mute()
     }
 
     for ( int i = 0; i < VST::NUM_COMBS; i++ ) {
-        _combFilter->filters.at( i )->mute();
+        _combs[ i ].mute();
     }
 
     for ( int i = 0; i < VST::NUM_ALLPASSES; i++ ) {
-        _allpassFilter->filters.at( i )->mute();
+        _allpasses[ i ].mute();
+    }
+
+    for ( int i = 0; i < VST::NUM_DIFFUSERS; i++ ) {
+        _diffusers[ i ].mute();
     }
 }
 
@@ -138,50 +146,123 @@ void Reverb::toggleFreeze()
     setMode( getMode() == 1 ? INITIAL_MODE : FREEZE_MODE );
 }
 
-void Reverb::setupFilters()
+void Reverb::setDense( bool value )
 {
-    clearFilters();
+    if ( value && !_dense ) {
+        // diffusers hold no relevant content when not in use
+        for ( int i = 0; i < VST::NUM_DIFFUSERS; i++ ) {
+            _diffusers[ i ].mute();
+        }
+    }
+    _dense = value;
+}
+
+bool Reverb::isDense()
+{
+    return _dense;
+}
+
+void Reverb::setEconomy( bool value )
+{
+    if ( !value && _economy ) {
+        // the skipped combs and diffusers hold no relevant content
+        for ( int i = 1; i < VST::NUM_COMBS; i += 2 ) {
+            _combs[ i ].mute();
+        }
+        for ( int i = 0; i < VST::NUM_DIFFUSERS; i++ ) {
+            _diffusers[ i ].mute();
+        }
+    }
+    _economy = value;
+}
+
+bool Reverb::isEconomy()
+{
+    return _economy;
+}
 
-    // create filters and buffers per output channel
+void Reverb::setSampleRate( float sampleRate )
+{
+    _sampleRate = sampleRate;
 
-    // comb filter
-    _combFilter = new CombFilter();
+    float* line = _lineMemory;
 
     for ( int i = 0; i < VST::NUM_COMBS; ++i ) {
-        // tune the comb to the host environments sample rate
-        int tuning = ( int ) ((( float ) VST::COMB_TUNINGS[ i ] / 44100.f ) * VST::SAMPLE_RATE );
-        int size = tuning + ( /*c **/ STEREO_SPREAD );
-        float* buffer = new float[ size ];
+        Comb* comb = &_combs[ i ];
+        comb->setBuffer( line, getLineSize( VST::COMB_TUNINGS[ i ], sampleRate ));
+        comb->mute();
 
-        Comb* comb = new Comb();
-        comb->setBuffer( buffer, size );
+        line += getLineSize( VST::COMB_TUNINGS[ i ], VST::MAX_SAMPLE_RATE );
+    }
+
+    for ( int i = 0; i < VST::NUM_ALLPASSES; ++i ) {
+        AllPass* allPass = &_allpasses[ i ];
+        allPass->setBuffer( line, getLineSize( VST::ALLPASS_TUNINGS[ i ], sampleRate ));
+        allPass->mute();
 
-        _combFilter->filters.push_back( comb );
-        _combFilter->buffers.push_back( buffer );
+        line += getLineSize( VST::ALLPASS_TUNINGS[ i ], VST::MAX_SAMPLE_RATE );
     }
 
-    // all pass filter
+    for ( int i = 0; i < VST::NUM_DIFFUSERS; ++i ) {
+        AllPass* diffuser = &_diffusers[ i ];
+        diffuser->setBuffer( line, getLineSize( VST::DIFFUSER_TUNINGS[ i ], sampleRate ));
+        diffuser->mute();
 
-    _allpassFilter = new AllPassFilter();
+        line += getLineSize( VST::DIFFUSER_TUNINGS[ i ], VST::MAX_SAMPLE_RATE );
+    }
+}
 
-    for ( int i = 0; i < VST::NUM_ALLPASSES; ++i ) {
-        // tune the comb to the host environments sample rate
-        int tuning = ( int ) ((( float ) VST::ALLPASS_TUNINGS[ i ] / 44100.f ) * VST::SAMPLE_RATE );
-        int size = tuning + ( /*c **/ STEREO_SPREAD );
-        float* buffer = new float[ size ];
+void Reverb::setupFilters()
+{
+    clearFilters();
+
+    // reserve the memory for all lines at once (unless provided), sized for the highest supported sample rate
+
+    if ( _ownsLineMemory ) {
+        _lineMemory = new float[ getLineMemorySize() ];
+    }
 
-        AllPass* allPass = new AllPass();
-        allPass->setBuffer( buffer, size );
+    // the filter lines are assigned when tuning to the sample rate
 
-        _allpassFilter->filters.push_back( allPass );
-        _allpassFilter->buffers.push_back( buffer );
+    for ( int i = 0; i < VST::NUM_DIFFUSERS; ++i ) {
+        _diffusers[ i ].setFeedback( DIFFUSION );
     }
+
+    setSampleRate( _sampleRate );
 }
 
 void Reverb::clearFilters()
 {
-    delete _combFilter;
-    delete _allpassFilter;
+    if ( _ownsLineMemory ) {
+        delete[] _lineMemory;
+        _lineMemory = nullptr;
+    }
+}
+
+int Reverb::getLineMemorySize()
+{
+    int memorySize = 0;
+
+    for ( int i = 0; i < VST::NUM_COMBS; ++i ) {
+        memorySize += getLineSize( VST::COMB_TUNINGS[ i ], VST::MAX_SAMPLE_RATE );
+    }
+
+    for ( int i = 0; i < VST::NUM_ALLPASSES; ++i ) {
+        memorySize += getLineSize( VST::ALLPASS_TUNINGS[ i ], VST::MAX_SAMPLE_RATE );
+    }
+
+    for ( int i = 0; i < VST::NUM_DIFFUSERS; ++i ) {
+        memorySize += getLineSize( VST::DIFFUSER_TUNINGS[ i ], VST::MAX_SAMPLE_RATE );
+    }
+    return memorySize;
+}
+
+int Reverb::getLineSize( int tuning, float sampleRate )
+{
+    // tunings are defined for 44.1 kHz, scale these to the given sample rate
+
+    float rate = std::min( sampleRate, VST::MAX_SAMPLE_RATE );
+    return ( int ) ((( float ) tuning / 44100.f ) * rate ) + STEREO_SPREAD;
 }
 
 void Reverb::update()
@@ -203,8 +284,8 @@ void Reverb::update()
     }
 
     for ( int i = 0; i < VST::NUM_COMBS; i++ ) {
-        _combFilter->filters.at( i )->setFeedback( _roomSize1 );
-        _combFilter->filters.at( i )->setDamp( _damp1 );
+        _combs[ i ].setFeedback( _roomSize1 );
+        _combs[ i ].setDamp( _damp1 );
     }
 }
 
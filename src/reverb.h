@@ -27,45 +27,12 @@
 #include "audiobuffer.h"
 #include "comb.h"
 #include "allpass.h"
-#include <vector>
 
 using namespace Steinberg;
 
 namespace Igorski {
 class Reverb {
 
-    struct CombFilter {
-        std::vector<Comb*> filters;
-        std::vector<float*> buffers;
-
-        ~CombFilter() {
-            while ( !filters.empty() ) {
-                delete filters.at( 0 );
-                filters.erase( filters.begin() );
-            }
-            while ( !buffers.empty() ) {
-                delete buffers.at( 0 );
-                buffers.erase( buffers.begin() );
-            }
-        }
-    };
-
-    struct AllPassFilter {
-        std::vector<AllPass*> filters;
-        std::vector<float*> buffers;
-
-        ~AllPassFilter() {
-            while ( !filters.empty() ) {
-                delete filters.at( 0 );
-                filters.erase( filters.begin() );
-            }
-            while ( !buffers.empty() ) {
-                delete buffers.at( 0 );
-                buffers.erase( buffers.begin() );
-            }
-        }
-    };
-
     static constexpr float MAX_RECORD_TIME_MS = 5000.f;
     static constexpr float MUTED              = 0;
     static constexpr float FIXED_GAIN         = 0.015f;
@@ -81,12 +48,19 @@ class Reverb {
     static constexpr float INITIAL_WIDTH      = 1;
     static constexpr float INITIAL_MODE       = 0;
     static constexpr float FREEZE_MODE        = 0.5f;
+    static constexpr float DIFFUSION          = 0.625f; // feedback of the diffusers (when dense)
+    static constexpr float ECONOMY_GAIN       = 1.4142135f; // compensates for the combs skipped in economy
     static constexpr int STEREO_SPREAD        = 23;
 
     public:
-        Reverb();
+        // the line memory can optionally be provided (for instance when allocated within an Arena)
+        // it must hold getLineMemorySize() samples and remains owned by the caller
+
+        Reverb( float sampleRate, float* lineMemory = nullptr );
         ~Reverb();
 
+        static int getLineMemorySize();
+
         // apply effect to incoming sampleBuffer contents
 
         void process( float* inBuffer, int bufferSize );
@@ -98,16 +72,31 @@ class Reverb {
             float processedSample = 0;
             inputSample *= _gain;
 
-            // accumulate comb filters in parallel
+            float combInput = inputSample;
 
-            for ( int i = 0; i < VST::NUM_COMBS; i++ ) {
-                processedSample += _combFilter->filters.at( i )->process( inputSample );
+            if ( _dense && !_economy ) {
+                for ( int i = 0; i < VST::NUM_DIFFUSERS; i++ ) {
+                    combInput = _diffusers[ i ].diffuse( combInput );
+                }
+            }
+
+            // accumulate comb filters in parallel (in economy only every other comb filter runs)
+
+            if ( _economy ) {
+                for ( int i = 0; i < VST::NUM_COMBS; i += 2 ) {
+                    processedSample += _combs[ i ].process( combInput );
+                }
+                processedSample *= ECONOMY_GAIN;
+            } else {
+                for ( int i = 0; i < VST::NUM_COMBS; i++ ) {
+                    processedSample += _combs[ i ].process( combInput );
+                }
             }
 
             // feed through all pass filters in series
 
             for ( int i = 0; i < VST::NUM_ALLPASSES; i++ ) {
-                processedSample = _allpassFilter->filters.at( i )->process( processedSample );
+                processedSample = _allpasses[ i ].process( processedSample );
             }
 
             // wet mix (e.g. the reverberated signal) and dry mix (e.g. mix in the input signal)
@@ -129,11 +118,29 @@ class Reverb {
         void setMode( float value );
         void toggleFreeze();
 
+        // when dense, the input is smeared by a series of allpass diffusers before it reaches
+        // the comb filters, which thickens the early reflections at the expense of extra CPU
+
+        void setDense( bool value );
+        bool isDense();
+
+        // in economy, half of the comb filters run (and the input isn't diffused), which roughly halves
+        // the CPU cost at the expense of a sparser tail. This can be toggled from the audio thread
+
+        void setEconomy( bool value );
+        bool isEconomy();
+
+        // retunes the comb and allpass lines to given sample rate. this does not
+        // allocate (line memory is reserved for VST::MAX_SAMPLE_RATE upon construction)
+        // but does flush the reverb tail, so invoke this outside of the audio thread
+
+        void setSampleRate( float sampleRate );
+
     private:
         int  _amountOfChannels;
 
-        void setupFilters(); // generates comb and allpass filter buffers
-        void clearFilters(); // frees memory allocated to comb and allpass filter buffers
+        void setupFilters(); // reserves the line memory of the comb, allpass and diffuser filters (unless provided)
+        void clearFilters(); // frees the line memory of the comb, allpass and diffuser filters (when owned)
         void update();
 
         float _gain;
@@ -143,9 +150,23 @@ class Reverb {
         float _dry;
         float _width;
         float _mode;
+        bool  _dense = false;
+        bool  _economy = false;
+
+        // the filters are held by value, so a Reverb (and its filters) occupies a single allocation
+
+        Comb    _combs[ VST::NUM_COMBS ];
+        AllPass _allpasses[ VST::NUM_ALLPASSES ];
+        AllPass _diffusers[ VST::NUM_DIFFUSERS ];
+
+        // single block of memory holding all comb and allpass lines back to back
+        // each line is reserved at its length for the maximum supported sample rate
+
+        float* _lineMemory = nullptr;
+        bool   _ownsLineMemory = false;
+        float  _sampleRate;
 
-        CombFilter*     _combFilter   = nullptr;
-        AllPassFilter* _allpassFilter = nullptr;
+        static int getLineSize( int tuning, float sampleRate );
 };
 }
 
@@ -0,0 +1,183 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "ringbuffer.h"
+#include <algorithm>
+#include <string.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+RingBuffer::RingBuffer( int aAmountOfChannels, int aMinimumSize )
+{
+    amountOfChannels = aAmountOfChannels;
+    size             = std::max( 1, aMinimumSize );
+
+#ifdef __linux__
+    // the size of each channel must be a multiple of the memory page size for it to be mapped
+
+    int pageSamples = ( int ) ( sysconf( _SC_PAGESIZE ) / sizeof( float ));
+    if ( pageSamples > 0 ) {
+        size = (( size + pageSamples - 1 ) / pageSamples ) * pageSamples;
+    }
+#endif
+
+    _channelStride = ( size_t ) size * 2;
+
+    if ( !map() ) {
+        _channels = new float[ _channelStride * amountOfChannels ];
+    }
+    _segmentEpochs.resize(( size + SEGMENT_SIZE - 1 ) / SEGMENT_SIZE, _epoch );
+
+    silenceBuffers();
+}
+
+RingBuffer::~RingBuffer()
+{
+#ifdef __linux__
+    if ( _mapped ) {
+        munmap( _channels, _mappedBytes );
+        return;
+    }
+#endif
+    delete[] _channels;
+}
+
+/* public methods */
+
+void RingBuffer::silenceBuffers()
+{
+    // when mapped, erasing a channel also erases its mirror (zero bits should equal 0.f)
+
+    std::fill( _segmentEpochs.begin(), _segmentEpochs.end(), _epoch );
+
+    for ( int c = 0; c < amountOfChannels; ++c ) {
+        memset( getBufferForChannel( c ), 0, ( _mapped ? size : _channelStride ) * sizeof( float ));
+    }
+}
+
+void RingBuffer::prepareWrite( int position, int length )
+{
+    for ( int end = position + length; position < end; ) {
+        int index   = position < size ? position : position - size;
+        int segment = index >> SEGMENT_SHIFT;
+
+        if ( _segmentEpochs[ segment ] != _epoch ) {
+            silenceSegment( segment );
+            _segmentEpochs[ segment ] = _epoch;
+        }
+        int segmentEnd = std::min(( segment + 1 ) * SEGMENT_SIZE, size );
+        position += segmentEnd - index;
+    }
+}
+
+/* private methods */
+
+void RingBuffer::silenceSegment( int segment )
+{
+    int start  = segment * SEGMENT_SIZE;
+    int length = std::min(( int ) SEGMENT_SIZE, size - start );
+
+    for ( int c = 0; c < amountOfChannels; ++c ) {
+        float* buffer = getBufferForChannel( c );
+        memset( buffer + start, 0, length * sizeof( float ));
+
+        if ( !_mapped ) {
+            memset( buffer + start + size, 0, length * sizeof( float ));
+        }
+    }
+}
+
+bool RingBuffer::map()
+{
+#if defined( __linux__ ) && defined( MFD_CLOEXEC )
+    size_t channelBytes = ( size_t ) size * sizeof( float );
+    _mappedBytes = channelBytes * 2 * amountOfChannels;
+
+    // anonymous memory holding the actual contents of all channels
+
+    int fd = memfd_create( "darvaza-ringbuffer", MFD_CLOEXEC );
+    if ( fd < 0 ) {
+        return false;
+    }
+    if ( ftruncate( fd, ( off_t ) ( channelBytes * amountOfChannels )) != 0 ) {
+        close( fd );
+        return false;
+    }
+
+    // reserve the virtual address range for all channels and their mirrors, then map
+    // the memory of each channel twice, directly after each other, into the range
+
+    void* range = mmap( nullptr, _mappedBytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    if ( range == MAP_FAILED ) {
+        close( fd );
+        return false;
+    }
+
+    char* address = ( char* ) range;
+    bool mapped   = true;
+
+    for ( int c = 0; c < amountOfChannels && mapped; ++c ) {
+        off_t offset = ( off_t ) ( channelBytes * c );
+        for ( int half = 0; half < 2; ++half ) {
+            void* target = address + channelBytes * ( c * 2 + half );
+            if ( mmap( target, channelBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, offset ) == MAP_FAILED ) {
+                mapped = false;
+                break;
+            }
+        }
+    }
+    close( fd ); // the mappings keep the memory alive
+
+    if ( !mapped ) {
+        munmap( range, _mappedBytes );
+        return false;
+    }
+    _channels = ( float* ) range;
+    _mapped   = true;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void RingBuffer::mirror( int aChannelNum, int position, int length )
+{
+    float* buffer = getBufferForChannel( aChannelNum );
+
+    // the range written within the channel is copied into the mirror, the range
+    // written beyond the channel (e.g. into the mirror) is copied back into the channel
+
+    int inChannel = std::min( length, size - position );
+    if ( inChannel > 0 ) {
+        memcpy( buffer + position + size, buffer + position, inChannel * sizeof( float ));
+    }
+
+    int inMirror = length - std::max( 0, inChannel );
+    if ( inMirror > 0 ) {
+        int mirrorStart = std::max( position, size );
+        memcpy( buffer + mirrorStart - size, buffer + mirrorStart, inMirror * sizeof( float ));
+    }
+}
@@ -0,0 +1,117 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __RINGBUFFER_H_INCLUDED__
+#define __RINGBUFFER_H_INCLUDED__
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * A RingBuffer holds multiple channels of audio of equal size, in which each channel
+ * is followed by its mirror image : for any position within the 0 - size range, reading
+ * or writing at position + size addresses the same sample. This allows reads and writes to
+ * be performed as contiguous spans (up to size samples in length) without checking for wrap-around.
+ *
+ * Where supported, the mirror is created by mapping the same physical memory twice back
+ * to back in virtual memory. Otherwise each channel is allocated twice and commit() copies
+ * written content into its mirrored counterpart.
+ *
+ * Each channel is divided into segments tagged with the epoch in which they were last
+ * written. Clearing the buffer only advances the epoch, after which stale segments are read
+ * back as silence and are erased lazily once they are written to again (see prepareWrite()).
+ */
+class RingBuffer
+{
+    public:
+        RingBuffer( int aAmountOfChannels, int aMinimumSize );
+        ~RingBuffer();
+
+        int amountOfChannels;
+        int size; // in samples, can be larger than requested (rounded up to the memory page size)
+
+        static const int SEGMENT_SHIFT = 11;
+        static const int SEGMENT_SIZE  = 1 << SEGMENT_SHIFT; // in samples
+
+        // NOTE : no bounds checking takes place, aChannelNum must be below amountOfChannels
+
+        inline float* getBufferForChannel( int aChannelNum ) {
+            return _channels + ( size_t ) aChannelNum * _channelStride;
+        }
+
+        // reads a single sample at given position (in the 0 - size * 2 range), returning
+        // silence when the position lies within a segment that was cleared and not written since
+
+        inline float read( int aChannelNum, int position ) {
+            int index = position < size ? position : position - size;
+
+            if ( _segmentEpochs[ index >> SEGMENT_SHIFT ] != _epoch ) {
+                return 0.f;
+            }
+            return getBufferForChannel( aChannelNum )[ position ];
+        }
+
+        // must be invoked before writing length samples at given position (in the 0 - size range)
+        // into the channels, this erases the stale segments within the range (when the
+        // buffer has been cleared since their last write), the amount of work is bounded by
+        // the amount of segments the range spans
+
+        void prepareWrite( int position, int length );
+
+        // must be invoked after writing length samples at given position (in the 0 - size range)
+        // into a channel, this ensures the mirror is in sync when it isn't mapped by virtual memory
+
+        inline void commit( int aChannelNum, int position, int length ) {
+            if ( !_mapped ) {
+                mirror( aChannelNum, position, length );
+            }
+        }
+
+        // erases the contents of all channels in constant time
+
+        inline void clear() {
+            ++_epoch;
+        }
+
+        void silenceBuffers();
+
+        // whether the mirror is created by the virtual memory mapping
+
+        inline bool isMapped() {
+            return _mapped;
+        }
+
+    private:
+        float* _channels;
+        size_t _channelStride; // twice the size, the channel and its mirror
+        size_t _mappedBytes;
+        bool   _mapped = false;
+
+        std::vector<unsigned int> _segmentEpochs;
+        unsigned int _epoch = 0;
+
+        bool map();
+        void mirror( int aChannelNum, int position, int length );
+        void silenceSegment( int segment );
+};
+
+#endif
@@ -21,68 +21,72 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "tablepool.h"
+#include "realtimecheck.h"
 
 namespace Igorski {
 
-std::map<WaveGenerator::WaveForms, WaveTable*> TablePool::_cachedTables;
+std::map<TablePool::TableKey, TablePool::PooledTable> TablePool::_cachedTables;
+std::mutex TablePool::_mutex;
 
-WaveTable* TablePool::getTable( WaveGenerator::WaveForms waveformType )
+WaveTable* TablePool::acquire( WaveGenerator::WaveForms waveformType, float sampleRate, int tableSize )
 {
-    std::map<WaveGenerator::WaveForms, WaveTable*>::iterator it = _cachedTables.find( waveformType );
+    RT_ASSERT_NOT_REALTIME( "TablePool::acquire" );
+
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    TableKey key = { waveformType, sampleRate, tableSize };
+    std::map<TableKey, PooledTable>::iterator it = _cachedTables.find( key );
 
     if ( it != _cachedTables.end())
     {
         // table existed, load the pooled version
-        return ( WaveTable* )( it->second );
+        ++it->second.references;
+        return it->second.table;
     }
-    return nullptr;
-}
 
-bool TablePool::setTable( WaveTable* waveTable, WaveGenerator::WaveForms waveformType )
-{
-    // don't set a table for the same type twice
+    // generate the table and insert it into the pools table map
+    // (note this happens while holding the lock so concurrently created instances don't generate the same table)
 
-    if ( hasTable( waveformType )) {
-        return false;
-    }
-    std::map<WaveGenerator::WaveForms, WaveTable*>::iterator it = _cachedTables.find( waveformType );
+    WaveTable* waveTable = WaveGenerator::generate( waveformType, sampleRate, tableSize );
+    _cachedTables.insert( std::pair<TableKey, PooledTable>( key, { waveTable, 1 }));
 
-    // insert the generated table into the pools table map
-    _cachedTables.insert( std::pair<WaveGenerator::WaveForms, WaveTable*>( waveformType, waveTable ));
-
-    return true;
+    return waveTable;
 }
 
-bool TablePool::hasTable( WaveGenerator::WaveForms waveformType )
+void TablePool::release( WaveTable* waveTable )
 {
-    std::map<WaveGenerator::WaveForms, WaveTable*>::iterator it = _cachedTables.find( waveformType );
-    return it != _cachedTables.end();
-}
+    RT_ASSERT_NOT_REALTIME( "TablePool::release" );
 
-bool TablePool::removeTable( WaveGenerator::WaveForms waveformType )
-{
-    std::map<WaveGenerator::WaveForms, WaveTable*>::iterator it = _cachedTables.find( waveformType );
+    std::lock_guard<std::mutex> lock( _mutex );
 
-    if ( it != _cachedTables.end())
+    std::map<TableKey, PooledTable>::iterator it;
+
+    for ( it = _cachedTables.begin(); it != _cachedTables.end(); it++ )
     {
-        delete ( WaveTable* )( it->second );
+        if ( it->second.table != waveTable ) {
+            continue;
+        }
+        if ( --it->second.references <= 0 ) {
+            delete it->second.table;
+            _cachedTables.erase( it );
+        }
+        return;
+    }
+}
 
-        _cachedTables.erase( it );
+bool TablePool::hasTable( WaveGenerator::WaveForms waveformType, float sampleRate, int tableSize )
+{
+    std::lock_guard<std::mutex> lock( _mutex );
 
-        return true;
-    }
-    return false;
+    TableKey key = { waveformType, sampleRate, tableSize };
+    return _cachedTables.find( key ) != _cachedTables.end();
 }
 
-void TablePool::flush()
+int TablePool::getAmountOfTables()
 {
-    std::map<WaveGenerator::WaveForms, WaveTable*>::iterator it;
+    std::lock_guard<std::mutex> lock( _mutex );
 
-    for ( it = _cachedTables.begin(); it != _cachedTables.end(); it++ )
-    {
-        delete ( WaveTable* )( it->second );
-    }
-    _cachedTables.clear();
+    return ( int ) _cachedTables.size();
 }
 
 } // E.O namespace Igorski
@@ -26,39 +26,60 @@
 #include "wavetable.h"
 #include "wavegenerator.h"
 #include <map>
+#include <mutex>
 
 namespace Igorski {
+
+/**
+ * TablePool maintains the WaveTables shared by all plugin instances within the process.
+ * Tables are keyed by their waveform, sample rate and table size and are reference counted :
+ * a table is generated upon its first acquisition and deleted once its last reference is released.
+ * All methods are thread safe (but can block, so these should not be invoked on the audio thread)
+ */
 class TablePool
 {
     public:
 
-        // retrieves the pooled table for given waveformType
+        // retrieves the pooled table for given waveformType, sample rate and table size
+        // the table is generated when it wasn't pooled yet. Each acquired table must
+        // be released using release() once it is no longer used
 
-        static WaveTable* getTable( WaveGenerator::WaveForms waveformType );
+        static WaveTable* acquire( WaveGenerator::WaveForms waveformType, float sampleRate, int tableSize );
 
-        // stores the given WaveTable for the given waveform type inside the pool.
-        // if the table was empty and the waveformType exists inside the WaveGenerator,
-        // the tables buffer contents are generated on the fly
-        // returns boolean success
+        // releases a reference to given table (previously retrieved using acquire()), the
+        // table is deleted when no references remain
 
-        static bool setTable( WaveTable* waveTable, WaveGenerator::WaveForms waveformType );
+        static void release( WaveTable* waveTable );
 
-        // query whether the pool has a WaveTable for given waveformType
+        // query whether the pool has a WaveTable for given properties
 
-        static bool hasTable( WaveGenerator::WaveForms waveformType );
+        static bool hasTable( WaveGenerator::WaveForms waveformType, float sampleRate, int tableSize );
 
-        // removes the reference to WaveTables of given waveformType
-        // also clears the table contents from memory
+        // the amount of tables currently held by the pool
 
-        static bool removeTable( WaveGenerator::WaveForms waveformType );
+        static int getAmountOfTables();
 
-        // clears all registered WaveTables and their contents
+    private:
 
-        static void flush();
+        struct TableKey {
+            WaveGenerator::WaveForms waveformType;
+            float sampleRate;
+            int tableSize;
 
-    private:
+            bool operator<( const TableKey& other ) const {
+                if ( waveformType != other.waveformType ) return waveformType < other.waveformType;
+                if ( sampleRate   != other.sampleRate )   return sampleRate   < other.sampleRate;
+                return tableSize < other.tableSize;
+            }
+        };
+
+        struct PooledTable {
+            WaveTable* table;
+            int references;
+        };
 
-        static std::map<WaveGenerator::WaveForms, WaveTable*> _cachedTables;
+        static std::map<TableKey, PooledTable> _cachedTables;
+        static std::mutex _mutex;
 };
 } // E.O namespace Igorski
 
@@ -22,6 +22,7 @@
  */
 #include "../global.h"
 #include "../calc.h"
+#include "../meter.h"
 #include "../plugin_process.h"
 #include "../paramids.h"
 #include "controller.h"
@@ -162,6 +163,68 @@ tresult PLUGIN_API PluginController::initialize( FUnknown* context )
         STR16( "Bypass" ), nullptr, 1, 0, ParameterInfo::kCanAutomate | ParameterInfo::kIsBypass, kBypassId
     );
 
+    // sidechain gate, the gate mode selects between the tempo synchronized LFO and
+    // following the envelope of the sidechain input (by its peak or RMS level)
+
+    parameters.addParameter(
+        USTRING( "Gate mode" ), 0, 2, 0, ParameterInfo::kCanAutomate | ParameterInfo::kIsList, kGateModeId, unitId
+    );
+
+    RangeParameter* sideChainAttackParam = new RangeParameter(
+        USTRING( "Sidechain attack" ), kSideChainAttackId, USTRING( "ms" ),
+        0.f, 1.f, .667f,
+        0, ParameterInfo::kCanAutomate, unitId
+    );
+    parameters.addParameter( sideChainAttackParam );
+
+    RangeParameter* sideChainReleaseParam = new RangeParameter(
+        USTRING( "Sidechain release" ), kSideChainReleaseId, USTRING( "ms" ),
+        0.f, 1.f, .5f,
+        0, ParameterInfo::kCanAutomate, unitId
+    );
+    parameters.addParameter( sideChainReleaseParam );
+
+    RangeParameter* sideChainThresholdParam = new RangeParameter(
+        USTRING( "Sidechain threshold" ), kSideChainThresholdId, USTRING( "dB" ),
+        0.f, 1.f, .333f,
+        0, ParameterInfo::kCanAutomate, unitId
+    );
+    parameters.addParameter( sideChainThresholdParam );
+
+    // output limiter, the lookahead modes add latency
+
+    parameters.addParameter(
+        USTRING( "Limiter mode" ), 0, 2, 1, ParameterInfo::kCanAutomate | ParameterInfo::kIsList, kLimiterModeId, unitId
+    );
+
+    // the algorithmic reverb engine, FDN provides a denser tail for roughly the same CPU
+    // cost (either is replaced by the convolution engine while an impulse response is loaded)
+
+    parameters.addParameter(
+        USTRING( "Reverb engine" ), 0, 1, 0, ParameterInfo::kCanAutomate | ParameterInfo::kIsList, kReverbEngineId, unitId
+    );
+
+    // the processing quality, automatically selected by the process mode of the host unless
+    // chosen explicitly (for instance to render in high quality while processing in real-time)
+
+    parameters.addParameter(
+        USTRING( "Quality mode" ), 0, 2, 0, ParameterInfo::kCanAutomate | ParameterInfo::kIsList, kQualityModeId, unitId
+    );
+
+    // meters (read-only, updated by the processor)
+
+    parameters.addParameter( STR16( "Output peak" ),    STR16( "dB" ), 0, 0, ParameterInfo::kIsReadOnly, kVuPPMId,         unitId );
+    parameters.addParameter( STR16( "Output RMS" ),     STR16( "dB" ), 0, 0, ParameterInfo::kIsReadOnly, kOutputRMSId,     unitId );
+    parameters.addParameter( STR16( "Input peak" ),     STR16( "dB" ), 0, 0, ParameterInfo::kIsReadOnly, kInputPeakId,     unitId );
+    parameters.addParameter( STR16( "Input RMS" ),      STR16( "dB" ), 0, 0, ParameterInfo::kIsReadOnly, kInputRMSId,      unitId );
+    parameters.addParameter( STR16( "Gain reduction" ), STR16( "dB" ), 0, 0, ParameterInfo::kIsReadOnly, kGainReductionId, unitId );
+
+    // processing state (read-only, updated by the processor)
+
+    parameters.addParameter( STR16( "Process load" ), STR16( "%" ), 0, 0, ParameterInfo::kIsReadOnly, kProcessLoadId, unitId );
+    parameters.addParameter( STR16( "Quality tier" ), nullptr, Igorski::PluginProcess::QualityTiers::NO_OVERSAMPLING, 0,
+                             ParameterInfo::kIsReadOnly | ParameterInfo::kIsList, kQualityTierId, unitId );
+
     // initialization
 
     String str( "Darvaza" );
@@ -173,6 +236,8 @@ tresult PLUGIN_API PluginController::initialize( FUnknown* context )
 //------------------------------------------------------------------------
 tresult PLUGIN_API PluginController::terminate()
 {
+    stopMeterPolling();
+
     return EditControllerEx1::terminate ();
 }
 
@@ -277,7 +342,79 @@ tresult PLUGIN_API PluginController::setComponentState( IBStream* state )
 
         setParamNormalized( kBypassId, savedBypass ? 1 : 0 );
 
-        state->seek( sizeof ( float ), IBStream::kIBSeekCur );
+        // skip the impulse response path, the sidechain gate properties follow it
+        // (states saved by earlier versions end before either of these, and use the
+        // CLASSIC limiter mode, see below)
+
+        int32 savedImpulseResponsePathLength = 0;
+        if ( state->read( &savedImpulseResponsePathLength, sizeof( int32 )) != kResultOk ) {
+            setParamNormalized( kLimiterModeId, 0.f );
+            return kResultOk;
+        }
+
+#if BYTEORDER == kBigEndian
+        SWAP_32( savedImpulseResponsePathLength );
+#endif
+        if ( savedImpulseResponsePathLength > 0 )
+            state->seek( savedImpulseResponsePathLength, IBStream::kIBSeekCur );
+
+        float savedGateMode = 0.f, savedSideChainAttack = 0.f, savedSideChainRelease = 0.f, savedSideChainThreshold = 0.f;
+
+        if ( state->read( &savedGateMode, sizeof( float )) == kResultOk &&
+             state->read( &savedSideChainAttack, sizeof( float )) == kResultOk &&
+             state->read( &savedSideChainRelease, sizeof( float )) == kResultOk &&
+             state->read( &savedSideChainThreshold, sizeof( float )) == kResultOk )
+        {
+#if BYTEORDER == kBigEndian
+            SWAP_32( savedGateMode );
+            SWAP_32( savedSideChainAttack );
+            SWAP_32( savedSideChainRelease );
+            SWAP_32( savedSideChainThreshold );
+#endif
+            setParamNormalized( kGateModeId,           savedGateMode );
+            setParamNormalized( kSideChainAttackId,    savedSideChainAttack );
+            setParamNormalized( kSideChainReleaseId,   savedSideChainRelease );
+            setParamNormalized( kSideChainThresholdId, savedSideChainThreshold );
+        }
+
+        // the limiter mode follows the sidechain gate properties (states saved by
+        // earlier versions end before it and use the CLASSIC mode, see Darvaza::setState())
+
+        float savedLimiterMode = 0.f;
+
+        if ( state->read( &savedLimiterMode, sizeof( float )) == kResultOk )
+        {
+#if BYTEORDER == kBigEndian
+            SWAP_32( savedLimiterMode );
+#endif
+        } else {
+            savedLimiterMode = 0.f;
+        }
+        setParamNormalized( kLimiterModeId, savedLimiterMode );
+
+        // followed by the reverb engine
+
+        float savedReverbEngine = 0.f;
+
+        if ( state->read( &savedReverbEngine, sizeof( float )) == kResultOk )
+        {
+#if BYTEORDER == kBigEndian
+            SWAP_32( savedReverbEngine );
+#endif
+            setParamNormalized( kReverbEngineId, savedReverbEngine );
+        }
+
+        // followed by the quality mode
+
+        float savedQualityMode = 0.f;
+
+        if ( state->read( &savedQualityMode, sizeof( float )) == kResultOk )
+        {
+#if BYTEORDER == kBigEndian
+            SWAP_32( savedQualityMode );
+#endif
+            setParamNormalized( kQualityModeId, savedQualityMode );
+        }
     }
     return kResultOk;
 }
@@ -366,6 +503,23 @@ tresult PLUGIN_API PluginController::setParamNormalized( ParamID tag, ParamValue
 {
     // called from host to update our parameters state
     tresult result = EditControllerEx1::setParamNormalized( tag, value );
+
+    // the lookahead modes of the limiter add latency, request the host to query the new latency
+
+    if ( tag == kLimiterModeId )
+    {
+        Igorski::PluginProcess::LimiterModes limiterMode = Igorski::PluginProcess::toLimiterMode(( float ) value );
+
+        if ( limiterMode != lastLimiterMode )
+        {
+            bool latencyChanged = ( limiterMode == Igorski::PluginProcess::LimiterModes::CLASSIC ) !=
+                                  ( lastLimiterMode == Igorski::PluginProcess::LimiterModes::CLASSIC );
+            lastLimiterMode = limiterMode;
+
+            if ( latencyChanged )
+                restartForLatency();
+        }
+    }
     return result;
 }
 
@@ -488,12 +642,291 @@ tresult PLUGIN_API PluginController::getParamStringByValue( ParamID tag, ParamVa
 
 // --- AUTO-GENERATED GETPARAM END
 
+        case kVuPPMId:
+        case kOutputRMSId:
+        case kInputPeakId:
+        case kInputRMSId:
+            if ( valueNormalized <= 0.f ) {
+                sprintf( text, "-inf" );
+            } else {
+                sprintf( text, "%.1f", Igorski::Meter::normalizedToDecibels( valueNormalized ));
+            }
+            Steinberg::UString( string, 128 ).fromAscii( text );
+            return kResultTrue;
+
+        case kGainReductionId:
+            sprintf( text, "%.1f", Igorski::Meter::normalizedToGainReduction( valueNormalized ));
+            Steinberg::UString( string, 128 ).fromAscii( text );
+            return kResultTrue;
+
+        case kProcessLoadId:
+            sprintf( text, "%.d %%", ( int ) round( Igorski::DeadlineMonitor::normalizedToLoad( valueNormalized ) * 100.f ));
+            Steinberg::UString( string, 128 ).fromAscii( text );
+            return kResultTrue;
+
+        case kQualityTierId:
+            switch (( int ) round( valueNormalized * Igorski::PluginProcess::QualityTiers::NO_OVERSAMPLING )) {
+                default:
+                    sprintf( text, "Full" );
+                    break;
+                case Igorski::PluginProcess::QualityTiers::LINEAR_INTERPOLATION:
+                    sprintf( text, "Linear interpolation" );
+                    break;
+                case Igorski::PluginProcess::QualityTiers::REDUCED_REVERB:
+                    sprintf( text, "Reduced reverb" );
+                    break;
+                case Igorski::PluginProcess::QualityTiers::NO_OVERSAMPLING:
+                    sprintf( text, "No oversampling" );
+                    break;
+            }
+            Steinberg::UString( string, 128 ).fromAscii( text );
+            return kResultTrue;
+
+        case kGateModeId:
+            switch (( int ) round( valueNormalized * Igorski::PluginProcess::GateModes::SIDECHAIN_RMS )) {
+                default:
+                    sprintf( text, "LFO" );
+                    break;
+                case Igorski::PluginProcess::GateModes::SIDECHAIN_PEAK:
+                    sprintf( text, "Sidechain peak" );
+                    break;
+                case Igorski::PluginProcess::GateModes::SIDECHAIN_RMS:
+                    sprintf( text, "Sidechain RMS" );
+                    break;
+            }
+            Steinberg::UString( string, 128 ).fromAscii( text );
+            return kResultTrue;
+
+        case kLimiterModeId:
+            switch ( Igorski::PluginProcess::toLimiterMode(( float ) valueNormalized )) {
+                default:
+                    sprintf( text, "Classic" );
+                    break;
+                case Igorski::PluginProcess::LimiterModes::LOOKAHEAD:
+                    sprintf( text, "Lookahead" );
+                    break;
+                case Igorski::PluginProcess::LimiterModes::TRUE_PEAK:
+                    sprintf( text, "True peak" );
+                    break;
+            }
+            Steinberg::UString( string, 128 ).fromAscii( text );
+            return kResultTrue;
+
+        case kReverbEngineId:
+            if ( Igorski::PluginProcess::toReverbEngine(( float ) valueNormalized ) == Igorski::PluginProcess::ReverbEngines::FDN ) {
+                sprintf( text, "FDN" );
+            } else {
+                sprintf( text, "Freeverb" );
+            }
+            Steinberg::UString( string, 128 ).fromAscii( text );
+            return kResultTrue;
+
+        case kQualityModeId:
+            switch ( Igorski::PluginProcess::toQualitySelection(( float ) valueNormalized )) {
+                default:
+                    sprintf( text, "Automatic" );
+                    break;
+                case Igorski::PluginProcess::QualitySelections::REALTIME_QUALITY:
+                    sprintf( text, "Real-time" );
+                    break;
+                case Igorski::PluginProcess::QualitySelections::OFFLINE_QUALITY:
+                    sprintf( text, "High quality" );
+                    break;
+            }
+            Steinberg::UString( string, 128 ).fromAscii( text );
+            return kResultTrue;
+
+        case kSideChainAttackId:
+            sprintf( text, "%.1f ms", Igorski::Calc::scaleExponential(( float ) valueNormalized,
+                Igorski::PluginProcess::MIN_SIDECHAIN_ATTACK_MS, Igorski::PluginProcess::MAX_SIDECHAIN_ATTACK_MS ));
+            Steinberg::UString( string, 128 ).fromAscii( text );
+            return kResultTrue;
+
+        case kSideChainReleaseId:
+            sprintf( text, "%.d ms", ( int ) Igorski::Calc::scaleExponential(( float ) valueNormalized,
+                Igorski::PluginProcess::MIN_SIDECHAIN_RELEASE_MS, Igorski::PluginProcess::MAX_SIDECHAIN_RELEASE_MS ));
+            Steinberg::UString( string, 128 ).fromAscii( text );
+            return kResultTrue;
+
+        case kSideChainThresholdId:
+            sprintf( text, "%.1f dB", Igorski::PluginProcess::MIN_SIDECHAIN_THRESHOLD_DB * ( 1.f - valueNormalized ));
+            Steinberg::UString( string, 128 ).fromAscii( text );
+            return kResultTrue;
+
         // everything else
         default:
             return EditControllerEx1::getParamStringByValue( tag, valueNormalized, string );
     }
 }
 
+//------------------------------------------------------------------------
+tresult PLUGIN_API PluginController::notify( IMessage* message )
+{
+    if ( !message )
+        return kInvalidArgument;
+
+    // meter values sent by the processor in reply to requestMeterData()
+
+    if ( !strcmp( message->getMessageID(), "MeterData" ))
+    {
+        IAttributeList* attributes = message->getAttributes();
+        double inputPeak = 0, inputRMS = 0, outputPeak = 0, outputRMS = 0, gainReduction = 1, processLoad = 0;
+        int64 qualityTier = 0;
+
+        attributes->getFloat( "InputPeak",     inputPeak );
+        attributes->getFloat( "InputRMS",      inputRMS );
+        attributes->getFloat( "OutputPeak",    outputPeak );
+        attributes->getFloat( "OutputRMS",     outputRMS );
+        attributes->getFloat( "GainReduction", gainReduction );
+        attributes->getFloat( "ProcessLoad",   processLoad );
+        attributes->getInt( "QualityTier",     qualityTier );
+        attributes->getInt( "NearMisses",      deadlineNearMisses );
+        attributes->getInt( "Overruns",        deadlineOverruns );
+
+        setParamNormalized( kVuPPMId,         Igorski::Meter::levelToNormalized(( float ) outputPeak ));
+        setParamNormalized( kOutputRMSId,     Igorski::Meter::levelToNormalized(( float ) outputRMS ));
+        setParamNormalized( kInputPeakId,     Igorski::Meter::levelToNormalized(( float ) inputPeak ));
+        setParamNormalized( kInputRMSId,      Igorski::Meter::levelToNormalized(( float ) inputRMS ));
+        setParamNormalized( kGainReductionId, Igorski::Meter::gainReductionToNormalized(( float ) gainReduction ));
+        setParamNormalized( kProcessLoadId,   Igorski::DeadlineMonitor::loadToNormalized(( float ) processLoad ));
+        setParamNormalized( kQualityTierId,   ( float ) qualityTier / Igorski::PluginProcess::QualityTiers::NO_OVERSAMPLING );
+
+        return kResultOk;
+    }
+
+#ifdef DARVAZA_PROFILE
+    // profiler statistics sent by the processor in reply to requestProfileData()
+
+    if ( !strcmp( message->getMessageID(), "ProfileData" ))
+    {
+        IAttributeList* attributes = message->getAttributes();
+        Igorski::Profiler::Statistics statistics;
+        int64 blocks = 0, droppedBlocks = 0;
+        double value = 0, budget = 0;
+        char attributeId[ 64 ];
+
+        attributes->getInt( "Blocks", blocks );
+        attributes->getInt( "DroppedBlocks", droppedBlocks );
+        attributes->getFloat( "BlockBudget", budget );
+
+        statistics.blocks        = ( int ) blocks;
+        statistics.droppedBlocks = ( int ) droppedBlocks;
+
+        if ( attributes->getFloat( "BufferSize", value ) == kResultOk )    statistics.meanBufferSize = ( float ) value;
+        if ( attributes->getFloat( "MeanBlockTime", value ) == kResultOk ) statistics.meanBlockTime  = ( float ) value;
+        if ( attributes->getFloat( "MaxBlockTime", value ) == kResultOk )  statistics.maxBlockTime   = ( float ) value;
+
+        for ( int i = 0; i < Igorski::Profiler::AMOUNT_OF_STAGES; ++i ) {
+            snprintf( attributeId, sizeof( attributeId ), "MeanTime.%s", Igorski::Profiler::STAGE_NAMES[ i ]);
+            if ( attributes->getFloat( attributeId, value ) == kResultOk ) statistics.meanStageTimes[ i ] = ( float ) value;
+
+            snprintf( attributeId, sizeof( attributeId ), "MaxTime.%s", Igorski::Profiler::STAGE_NAMES[ i ]);
+            if ( attributes->getFloat( attributeId, value ) == kResultOk ) statistics.maxStageTimes[ i ] = ( float ) value;
+        }
+
+        if ( statistics.blocks == 0 )
+            return kResultOk; // nothing processed since the previous request
+
+        profileStatistics  = statistics;
+        profileBlockBudget = ( float ) budget;
+
+        fprintf( stderr, "[Darvaza] %d blocks, mean %.1f us, max %.1f us (%.1f%% of %.1f us budget), %d dropped\n",
+                 statistics.blocks, statistics.meanBlockTime, statistics.maxBlockTime,
+                 budget > 0 ? 100.0 * statistics.meanBlockTime / budget : 0.0, budget, statistics.droppedBlocks );
+
+        for ( int i = 0; i < Igorski::Profiler::AMOUNT_OF_STAGES; ++i ) {
+            fprintf( stderr, "[Darvaza]   %-10s mean %.1f us, max %.1f us\n", Igorski::Profiler::STAGE_NAMES[ i ],
+                     statistics.meanStageTimes[ i ], statistics.maxStageTimes[ i ]);
+        }
+        return kResultOk;
+    }
+#endif
+    // the processor reports that its latency has changed (e.g. after a change of sample rate)
+
+    if ( !strcmp( message->getMessageID(), "LatencyChanged" ))
+    {
+        restartForLatency();
+        return kResultOk;
+    }
+    return EditControllerEx1::notify( message );
+}
+
+//------------------------------------------------------------------------
+void PluginController::restartForLatency()
+{
+    if ( componentHandler )
+        componentHandler->restartComponent( kLatencyChanged );
+}
+
+//------------------------------------------------------------------------
+void PluginController::didOpen( VST3Editor* /*editor*/ )
+{
+    // the meters are only polled while the editor is open, not all hosts
+    // send the output parameter changes of the processor back to the controller
+
+    if ( !meterTimer )
+    {
+        meterTimer = makeOwned<CVSTGUITimer>(
+            [ this ]( CVSTGUITimer* ) { requestMeterData(); },
+            ( uint32_t ) ( 1000.f / Igorski::Meter::UI_RATE ), true
+        );
+    }
+
+#ifdef DARVAZA_PROFILE
+    if ( !profileTimer )
+    {
+        profileTimer = makeOwned<CVSTGUITimer>(
+            [ this ]( CVSTGUITimer* ) { requestProfileData(); }, PROFILE_INTERVAL_MS, true
+        );
+    }
+#endif
+}
+
+//------------------------------------------------------------------------
+void PluginController::willClose( VST3Editor* /*editor*/ )
+{
+    stopMeterPolling();
+}
+
+//------------------------------------------------------------------------
+void PluginController::requestMeterData()
+{
+    if ( IPtr<IMessage> message = owned( allocateMessage()))
+    {
+        message->setMessageID( "MeterRequest" );
+        sendMessage( message );
+    }
+}
+
+//------------------------------------------------------------------------
+void PluginController::stopMeterPolling()
+{
+    if ( meterTimer )
+    {
+        meterTimer->stop();
+        meterTimer = nullptr;
+    }
+#ifdef DARVAZA_PROFILE
+    if ( profileTimer )
+    {
+        profileTimer->stop();
+        profileTimer = nullptr;
+    }
+#endif
+}
+
+#ifdef DARVAZA_PROFILE
+//------------------------------------------------------------------------
+void PluginController::requestProfileData()
+{
+    if ( IPtr<IMessage> message = owned( allocateMessage()))
+    {
+        message->setMessageID( "ProfileRequest" );
+        sendMessage( message );
+    }
+}
+#endif
+
 //------------------------------------------------------------------------
 tresult PLUGIN_API PluginController::getParamValueByString( ParamID tag, TChar* string, ParamValue& valueNormalized )
 {
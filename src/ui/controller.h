@@ -25,6 +25,9 @@
 
 #include "vstgui/plugin-bindings/vst3editor.h"
 #include "public.sdk/source/vst/vsteditcontroller.h"
+#include "vstgui/lib/cvstguitimer.h"
+#include "../plugin_process.h"
+#include "../profiler.h"
 
 #include <vector>
 
@@ -66,6 +69,7 @@ class PluginController : public EditControllerEx1, public IMidiMapping, public V
 
         //---from ComponentBase-----
         tresult receiveText( const char* text ) SMTG_OVERRIDE;
+        tresult PLUGIN_API notify( IMessage* message ) SMTG_OVERRIDE;
 
         //---from IMidiMapping-----------------
         tresult PLUGIN_API getMidiControllerAssignment (int32 busIndex, int16 channel,
@@ -75,6 +79,8 @@ class PluginController : public EditControllerEx1, public IMidiMapping, public V
         //---from VST3EditorDelegate-----------
         IController* createSubController( UTF8StringPtr name, const IUIDescription* description,
                                           VST3Editor* editor ) SMTG_OVERRIDE;
+        void didOpen( VST3Editor* editor ) SMTG_OVERRIDE;
+        void willClose( VST3Editor* editor ) SMTG_OVERRIDE;
 
         DELEGATE_REFCOUNT ( EditController )
         tresult PLUGIN_API queryInterface( const char* iid, void** obj ) SMTG_OVERRIDE;
@@ -86,11 +92,50 @@ class PluginController : public EditControllerEx1, public IMidiMapping, public V
         void setDefaultMessageText( String128 text );
         TChar* getDefaultMessageText();
 
+        // the amount of blocks the processor reported to have come close to exceeding (or
+        // exceeded) their real-time deadline since activation (see DeadlineMonitor)
+
+        int64 getDeadlineNearMisses() { return deadlineNearMisses; }
+        int64 getDeadlineOverruns() { return deadlineOverruns; }
+
+#ifdef DARVAZA_PROFILE
+        // the timings of the processing stages last reported by the processor (see profiler.h), along
+        // with the time available for processing a block (both in microseconds)
+
+        const Igorski::Profiler::Statistics& getProfileStatistics() { return profileStatistics; }
+        float getProfileBlockBudget() { return profileBlockBudget; }
+#endif
+
     private:
         typedef std::vector<UIMessageController*> UIMessageControllerList;
         UIMessageControllerList uiMessageControllers;
 
         String128 defaultMessageText;
+
+        // polls the processor for its meter values while the editor is open
+
+        SharedPointer<CVSTGUITimer> meterTimer;
+        void requestMeterData();
+        void stopMeterPolling();
+
+        int64 deadlineNearMisses = 0;
+        int64 deadlineOverruns   = 0;
+
+        // requests the host to query the latency of the processor, which depends on the limiter mode
+
+        Igorski::PluginProcess::LimiterModes lastLimiterMode = Igorski::PluginProcess::LimiterModes::TRUE_PEAK;
+        void restartForLatency();
+
+#ifdef DARVAZA_PROFILE
+        // polls the processor for its profiler statistics while the editor is open
+
+        static const uint32_t PROFILE_INTERVAL_MS = 1000;
+
+        SharedPointer<CVSTGUITimer> profileTimer;
+        Igorski::Profiler::Statistics profileStatistics;
+        float profileBlockBudget = 0.f;
+        void requestProfileData();
+#endif
 };
 
 //------------------------------------------------------------------------
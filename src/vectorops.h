@@ -0,0 +1,199 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __VECTOROPS_H_INCLUDED__
+#define __VECTOROPS_H_INCLUDED__
+
+#include "snd.h"
+#include <cmath>
+
+/**
+ * Element-wise operations on blocks of samples, shared by the processors whose
+ * inner loops reduce to simple arithmetic over buffers. The generic versions are
+ * written so the compiler can vectorize them, the 32-bit float versions use SSE
+ * intrinsics directly when available (as hosts mostly process in 32-bit)
+ */
+namespace Igorski {
+namespace VectorOps {
+
+    // when set, the SSE kernels (here and in the processors with kernels of their own) are skipped in
+    // favour of their scalar equivalents, so the output of both can be compared. This is a testing aid
+    // (see test/render_test.cpp) and is not to be changed while processing
+
+    inline bool forceScalar = false;
+
+    // output[ i ] = max( output[ i ], abs( input[ i ]))
+
+    template <typename SampleType>
+    inline void maxAbs( const SampleType* input, float* output, int length )
+    {
+        for ( int i = 0; i < length; ++i ) {
+            output[ i ] = std::fmax( output[ i ], ( float ) std::fabs( input[ i ]));
+        }
+    }
+
+    // buffer[ i ] *= gains[ i ] * scale
+
+    template <typename SampleType>
+    inline void multiply( SampleType* buffer, const float* gains, float scale, int length )
+    {
+        for ( int i = 0; i < length; ++i ) {
+            buffer[ i ] *= ( SampleType ) ( gains[ i ] * scale );
+        }
+    }
+
+    // buffer[ i ] *= amount
+
+    inline void scale( float* buffer, float amount, int length )
+    {
+        int i = 0;
+#ifdef USE_SSE_INTRINSICS
+        const __m128 amountVector = _mm_set1_ps( amount );
+        for ( ; !forceScalar && i + 4 <= length; i += 4 ) {
+            _mm_storeu_ps( buffer + i, _mm_mul_ps( _mm_loadu_ps( buffer + i ), amountVector ));
+        }
+#endif
+        for ( ; i < length; ++i ) {
+            buffer[ i ] *= amount;
+        }
+    }
+
+    // target[ i ] += source[ i ] * volume
+
+    inline void mix( const float* source, float* target, float volume, int length )
+    {
+        int i = 0;
+#ifdef USE_SSE_INTRINSICS
+        const __m128 volumeVector = _mm_set1_ps( volume );
+        for ( ; !forceScalar && i + 4 <= length; i += 4 ) {
+            __m128 mixed = _mm_add_ps( _mm_loadu_ps( target + i ), _mm_mul_ps( _mm_loadu_ps( source + i ), volumeVector ));
+            _mm_storeu_ps( target + i, mixed );
+        }
+#endif
+        for ( ; i < length; ++i ) {
+            target[ i ] += ( source[ i ] * volume );
+        }
+    }
+
+    // returns the highest absolute value within input
+
+    template <typename SampleType>
+    inline float peak( const SampleType* input, int length )
+    {
+        float max = 0.f;
+        for ( int i = 0; i < length; ++i ) {
+            max = std::fmax( max, ( float ) std::fabs( input[ i ]));
+        }
+        return max;
+    }
+
+    // returns the sum of the squared values of input (e.g. for RMS calculation)
+
+    template <typename SampleType>
+    inline double sumOfSquares( const SampleType* input, int length )
+    {
+        double sum = 0.0;
+        for ( int i = 0; i < length; ++i ) {
+            sum += ( double ) input[ i ] * ( double ) input[ i ];
+        }
+        return sum;
+    }
+
+#ifdef USE_SSE_INTRINSICS
+
+    template <>
+    inline void maxAbs( const float* input, float* output, int length )
+    {
+        const __m128 signMask = _mm_set1_ps( -0.f );
+        int i = 0;
+
+        for ( ; !forceScalar && i + 4 <= length; i += 4 ) {
+            __m128 value = _mm_andnot_ps( signMask, _mm_loadu_ps( input + i ));
+            _mm_storeu_ps( output + i, _mm_max_ps( _mm_loadu_ps( output + i ), value ));
+        }
+        for ( ; i < length; ++i ) {
+            output[ i ] = std::fmax( output[ i ], std::fabs( input[ i ]));
+        }
+    }
+
+    template <>
+    inline void multiply( float* buffer, const float* gains, float scale, int length )
+    {
+        const __m128 scaleVector = _mm_set1_ps( scale );
+        int i = 0;
+
+        for ( ; !forceScalar && i + 4 <= length; i += 4 ) {
+            __m128 gain = _mm_mul_ps( _mm_loadu_ps( gains + i ), scaleVector );
+            _mm_storeu_ps( buffer + i, _mm_mul_ps( _mm_loadu_ps( buffer + i ), gain ));
+        }
+        for ( ; i < length; ++i ) {
+            buffer[ i ] *= gains[ i ] * scale;
+        }
+    }
+
+    template <>
+    inline float peak( const float* input, int length )
+    {
+        const __m128 signMask = _mm_set1_ps( -0.f );
+        __m128 maxVector = _mm_setzero_ps();
+        int i = 0;
+
+        for ( ; !forceScalar && i + 4 <= length; i += 4 ) {
+            maxVector = _mm_max_ps( maxVector, _mm_andnot_ps( signMask, _mm_loadu_ps( input + i )));
+        }
+        alignas( 16 ) float lanes[ 4 ];
+        _mm_store_ps( lanes, maxVector );
+
+        float max = std::fmax( std::fmax( lanes[ 0 ], lanes[ 1 ]), std::fmax( lanes[ 2 ], lanes[ 3 ]));
+        for ( ; i < length; ++i ) {
+            max = std::fmax( max, std::fabs( input[ i ]));
+        }
+        return max;
+    }
+
+    template <>
+    inline double sumOfSquares( const float* input, int length )
+    {
+        // lanes accumulate in single precision, which is accurate enough for the block sizes processed
+        __m128 sumVector = _mm_setzero_ps();
+        int i = 0;
+
+        for ( ; !forceScalar && i + 4 <= length; i += 4 ) {
+            __m128 value = _mm_loadu_ps( input + i );
+            sumVector = _mm_add_ps( sumVector, _mm_mul_ps( value, value ));
+        }
+        alignas( 16 ) float lanes[ 4 ];
+        _mm_store_ps( lanes, sumVector );
+
+        double sum = ( double ) lanes[ 0 ] + lanes[ 1 ] + lanes[ 2 ] + lanes[ 3 ];
+        for ( ; i < length; ++i ) {
+            sum += ( double ) input[ i ] * input[ i ];
+        }
+        return sum;
+    }
+
+#endif
+
+} // E.O namespace VectorOps
+} // E.O namespace Igorski
+
+#endif
@@ -34,23 +34,25 @@
 #include "pluginterfaces/vst/vstpresetkeys.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 
 namespace Igorski {
 
-float VST::SAMPLE_RATE = 44100.f; // updated in setupProcessing()
+float VST::SAMPLE_RATE = 44100.f; // updated in setupProcessing(), only used for display purposes by the controller
 
 //------------------------------------------------------------------------
 // Plugin Implementation
 //------------------------------------------------------------------------
 Darvaza::Darvaza()
 : pluginProcess( nullptr )
-// , outputGainOld( 0.f )
 , currentProcessMode( -1 ) // -1 means not initialized
 {
     // register its editor class (the same as used in vstentry.cpp)
     setControllerClass( VST::PluginControllerUID );
 
-    pluginProcess = new PluginProcess( 2 );
+    // the PluginProcess is not created here but once the host has provided the processing
+    // setup (see createPluginProcess()), hosts instantiate (and restore the state of) a
+    // plugin well before its sample rate is known
 }
 
 //------------------------------------------------------------------------
@@ -58,6 +60,9 @@ Darvaza::~Darvaza()
 {
     // free all allocated resources
     delete pluginProcess;
+#ifdef DARVAZA_NULL_TEST
+    delete nullTest;
+#endif
 }
 
 //------------------------------------------------------------------------
@@ -70,8 +75,7 @@ tresult PLUGIN_API Darvaza::initialize( FUnknown* context )
         return result;
 
     //---create Audio In/Out buses------
-    addAudioInput ( STR16( "Stereo In" ),  SpeakerArr::kStereo );
-    addAudioOutput( STR16( "Stereo Out" ), SpeakerArr::kStereo );
+    createBuses( SpeakerArr::kStereo, SpeakerArr::kStereo, SpeakerArr::kStereo );
 
     //---create Event In/Out buses (1 bus with only 1 channel)------
     addEventInput( STR16( "Event In" ), 1 );
@@ -89,13 +93,42 @@ tresult PLUGIN_API Darvaza::terminate()
 //------------------------------------------------------------------------
 tresult PLUGIN_API Darvaza::setActive (TBool state)
 {
-    if (state)
+    if (state) {
+        createPluginProcess(); // in case the host did not call setupProcessing() first
         sendTextMessage( "Darvaza::setActive (true)" );
-    else
+    }
+    else {
         sendTextMessage( "Darvaza::setActive (false)" );
+#ifdef DARVAZA_PROFILE
+        // write the trace recorded while active (see createPluginProcess())
+
+        const char* tracePath = getenv( "DARVAZA_PROFILE_TRACE" );
+        if ( pluginProcess != nullptr && tracePath != nullptr && pluginProcess->profiler->writeChromeTrace( tracePath ))
+            fprintf( stderr, "[Darvaza] wrote profile trace to %s\n", tracePath );
+#endif
+#ifdef DARVAZA_NULL_TEST
+        // report the residual of the output rendered while active against the reference
+
+        if ( nullTest != nullptr ) {
+            Igorski::NullTest::Result result = nullTest->getResult();
+
+            fprintf( stderr, "[Darvaza] null test %s : %llu samples, %s, residual %.1f dB (peak %.1f dBFS)%s\n",
+                     nullTest->passes() ? "passed" : "FAILED", ( unsigned long long ) result.samples,
+                     result.bitExact ? "bit-exact" : "not bit-exact", result.residualDb, result.peakResidualDb,
+                     result.synchronized ? "" : ", reference lost sync (block size exceeded the maximum)" );
+
+            nullTest->reset();
+        }
+#endif
+    }
+
+    // reset output level meter and the processing state
+    _lastMeterValues = Igorski::Meter::Values();
+    _lastProcessLoad = 0.f;
+    _lastQualityTier = Igorski::PluginProcess::QualityTiers::FULL_QUALITY;
 
-    // reset output level meter
-    // outputGainOld = 0.f;
+    if ( state && pluginProcess != nullptr )
+        pluginProcess->deadlineMonitor->reset();
 
     // call our parent setActive
     return AudioEffect::setActive( state );
@@ -109,6 +142,19 @@ tresult PLUGIN_API Darvaza::process( ProcessData& data )
     // 2) Read inputs events coming from host (note on/off events)
     // 3) Apply the effect using the input buffer into the output buffer
 
+    if ( pluginProcess == nullptr )
+        return kNotInitialized; // not activated by the host
+
+#ifdef DARVAZA_PROFILE
+    // when rendering offline the blocks are processed faster than the controller collects their timings,
+    // collect them prior to processing the next block (which is fine as offline rendering isn't real-time)
+
+    if ( currentProcessMode == kOffline )
+        pluginProcess->profiler->collect();
+#endif
+
+    RT_SCOPE( "Darvaza::process" ); // also covers the model updates (see syncModel())
+
     //---1) Read input parameter changes-----------
     IParameterChanges* paramChanges = data.inputParameterChanges;
     if ( paramChanges )
@@ -194,6 +240,41 @@ tresult PLUGIN_API Darvaza::process( ProcessData& data )
 							_bypass = value >= 0.5f;
 						}
 						break;
+
+                    case kGateModeId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) == kResultTrue )
+                            fGateMode = ( float ) value;
+                        break;
+
+                    case kSideChainAttackId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) == kResultTrue )
+                            fSideChainAttack = ( float ) value;
+                        break;
+
+                    case kSideChainReleaseId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) == kResultTrue )
+                            fSideChainRelease = ( float ) value;
+                        break;
+
+                    case kSideChainThresholdId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) == kResultTrue )
+                            fSideChainThreshold = ( float ) value;
+                        break;
+
+                    case kLimiterModeId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) == kResultTrue )
+                            fLimiterMode = ( float ) value;
+                        break;
+
+                    case kReverbEngineId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) == kResultTrue )
+                            fReverbEngine = ( float ) value;
+                        break;
+
+                    case kQualityModeId:
+                        if ( paramQueue->getPoint( numPoints - 1, sampleOffset, value ) == kResultTrue )
+                            fQualityMode = ( float ) value;
+                        break;
                 }
                 syncModel();
             }
@@ -210,21 +291,28 @@ tresult PLUGIN_API Darvaza::process( ProcessData& data )
 
         isPlaying = data.processContext->state & ProcessContext::kPlaying;
 
-        if ( !wasPlaying && isPlaying ) {
-            pluginProcess->resetReadWritePointers();
-            pluginProcess->resetGates();
-        }
+#ifdef DARVAZA_NULL_TEST
+        Igorski::PluginProcess* processes[] = { pluginProcess, nullTest->reference };
+#else
+        Igorski::PluginProcess* processes[] = { pluginProcess };
+#endif
+        for ( Igorski::PluginProcess* process : processes ) {
+            if ( !wasPlaying && isPlaying ) {
+                process->resetReadWritePointers();
+                process->resetGates();
+            }
 
-        // clear the record buffers on sequencer start / stop to prevent slowed down playback from
-        // reading old data that has been recorded into its "future"
+            // clear the record buffers on sequencer start / stop to prevent slowed down playback from
+            // reading old data that has been recorded into its "future"
 
-        if ( wasPlaying != isPlaying ) {
-            pluginProcess->clearRecordBuffer();
-        }
+            if ( wasPlaying != isPlaying ) {
+                process->clearRecordBuffer();
+            }
 
-        if ( pluginProcess->setTempo( data.processContext->tempo,
-            data.processContext->timeSigNumerator, data.processContext->timeSigDenominator )) {
-            pluginProcess->setGateSpeed( fOddSpeed, fEvenSpeed, Calc::toBool( fLinkGates ));
+            if ( process->setTempo( data.processContext->tempo,
+                data.processContext->timeSigNumerator, data.processContext->timeSigDenominator )) {
+                process->setGateSpeed( fOddSpeed, fEvenSpeed, Calc::toBool( fLinkGates ));
+            }
         }
     }
 
@@ -250,20 +338,25 @@ tresult PLUGIN_API Darvaza::process( ProcessData& data )
     void** in  = getChannelBuffersPointer( processSetup, data.inputs [ 0 ] );
     void** out = getChannelBuffersPointer( processSetup, data.outputs[ 0 ] );
 
+    // the sidechain bus provides no channels while it is inactive
+
+    int32 numSideChainChannels = data.numInputs > 1 ? data.inputs[ 1 ].numChannels : 0;
+    void** sideChain = numSideChainChannels > 0 ? getChannelBuffersPointer( processSetup, data.inputs[ 1 ] ) : nullptr;
+
     bool isDoublePrecision = data.symbolicSampleSize == kSample64;
     bool isSilentInput  = data.inputs[ 0 ].silenceFlags != 0;
     bool isSilentOutput = false;
 
 	if ( _bypass )
 	{
-        // bypass mode, ensure output equals input
-
-		for ( int32 i = 0; i < numInChannels; i++ ) {
-			if ( in[ i ] != out[ i ]) {
-				memcpy( out[ i ], in[ i ], sampleFramesSize );
-			}
-		}
-        isSilentOutput = isSilentInput;
+        // bypass mode, ensure output equals input (delayed by the reported latency)
+
+        if ( isDoublePrecision )
+            pluginProcess->bypass<double>(( double** ) in, ( double** ) out, numInChannels, data.numSamples );
+        else
+            pluginProcess->bypass<float>(( float** ) in, ( float** ) out, numInChannels, data.numSamples );
+
+        isSilentOutput = isSilentInput && pluginProcess->getLatency() == 0;
 	}
 	else
     {
@@ -271,17 +364,33 @@ tresult PLUGIN_API Darvaza::process( ProcessData& data )
 
         if ( isDoublePrecision ) {
             // 64-bit samples, e.g. Reaper64
+#ifdef DARVAZA_NULL_TEST
+            nullTest->renderReference<double>(
+                ( double** ) in, numInChannels, numOutChannels, data.numSamples, ( double** ) sideChain, numSideChainChannels
+            );
+#endif
             pluginProcess->process<double>(
                 ( double** ) in, ( double** ) out, numInChannels, numOutChannels,
-                data.numSamples, sampleFramesSize
+                data.numSamples, sampleFramesSize, ( double** ) sideChain, numSideChainChannels
             );
+#ifdef DARVAZA_NULL_TEST
+            nullTest->compare<double>(( double** ) out, numOutChannels, data.numSamples );
+#endif
         }
         else {
             // 32-bit samples, e.g. Ableton Live...
+#ifdef DARVAZA_NULL_TEST
+            nullTest->renderReference<float>(
+                ( float** ) in, numInChannels, numOutChannels, data.numSamples, ( float** ) sideChain, numSideChainChannels
+            );
+#endif
             pluginProcess->process<float>(
                 ( float** ) in, ( float** ) out, numInChannels, numOutChannels,
-                data.numSamples, sampleFramesSize
+                data.numSamples, sampleFramesSize, ( float** ) sideChain, numSideChainChannels
             );
+#ifdef DARVAZA_NULL_TEST
+            nullTest->compare<float>(( float** ) out, numOutChannels, data.numSamples );
+#endif
         }
     }
 
@@ -289,21 +398,57 @@ tresult PLUGIN_API Darvaza::process( ProcessData& data )
 
     data.outputs[ 0 ].silenceFlags = isSilentOutput ? (( uint64 ) 1 << numOutChannels ) - 1 : 0;
    
-    // float outputGain = pluginProcess->limiter->getLinearGR();
     //---4) Write output parameter changes-----------
-    // IParameterChanges* outParamChanges = data.outputParameterChanges;
-    // // a new value of VuMeter will be sent to the host
-    // // (the host will send it back in sync to our controller for updating our editor)
-    // if ( !isDoublePrecision && outParamChanges && outputGainOld != outputGain ) {
-    //     int32 index = 0;
-    //     IParamValueQueue* paramQueue = outParamChanges->addParameterData( kVuPPMId, index );
-    //     if ( paramQueue )
-    //         paramQueue->addPoint( 0, outputGain, index );
-    // }
-    // outputGainOld = outputGain;
+    IParameterChanges* outParamChanges = data.outputParameterChanges;
+    // new meter values are published at UI rate and sent to the host when changed
+    // (the host will send them back in sync to our controller for updating our editor)
+    if ( outParamChanges )
+    {
+        Igorski::Meter::Values meterValues = pluginProcess->meter->read();
+
+        if ( meterValues.outputPeak != _lastMeterValues.outputPeak )
+            writeOutputParameter( outParamChanges, kVuPPMId, Igorski::Meter::levelToNormalized( meterValues.outputPeak ));
+
+        if ( meterValues.outputRMS != _lastMeterValues.outputRMS )
+            writeOutputParameter( outParamChanges, kOutputRMSId, Igorski::Meter::levelToNormalized( meterValues.outputRMS ));
+
+        if ( meterValues.inputPeak != _lastMeterValues.inputPeak )
+            writeOutputParameter( outParamChanges, kInputPeakId, Igorski::Meter::levelToNormalized( meterValues.inputPeak ));
+
+        if ( meterValues.inputRMS != _lastMeterValues.inputRMS )
+            writeOutputParameter( outParamChanges, kInputRMSId, Igorski::Meter::levelToNormalized( meterValues.inputRMS ));
+
+        if ( meterValues.gainReduction != _lastMeterValues.gainReduction )
+            writeOutputParameter( outParamChanges, kGainReductionId, Igorski::Meter::gainReductionToNormalized( meterValues.gainReduction ));
+
+        _lastMeterValues = meterValues;
+
+        // the load and quality tier as governed by the deadline monitor
+
+        float processLoad = pluginProcess->deadlineMonitor->read().load;
+        int   qualityTier = pluginProcess->getQualityTier();
+
+        if ( processLoad != _lastProcessLoad )
+            writeOutputParameter( outParamChanges, kProcessLoadId, Igorski::DeadlineMonitor::loadToNormalized( processLoad ));
+
+        if ( qualityTier != _lastQualityTier )
+            writeOutputParameter( outParamChanges, kQualityTierId, ( float ) qualityTier / Igorski::PluginProcess::QualityTiers::NO_OVERSAMPLING );
+
+        _lastProcessLoad = processLoad;
+        _lastQualityTier = qualityTier;
+    }
     return kResultOk;
 }
 
+//------------------------------------------------------------------------
+void Darvaza::writeOutputParameter( IParameterChanges* changes, ParamID id, float value )
+{
+    int32 index = 0;
+    IParamValueQueue* paramQueue = changes->addParameterData( id, index );
+    if ( paramQueue )
+        paramQueue->addPoint( 0, value, index );
+}
+
 //------------------------------------------------------------------------
 tresult Darvaza::receiveText( const char* text )
 {
@@ -376,6 +521,13 @@ tresult PLUGIN_API Darvaza::setState( IBStream* state )
     if ( state->read( &savedBypass, sizeof ( int32 )) != kResultOk )
         return kResultFalse;
 
+    // the impulse response path was added to the state at a later stage, states
+    // saved by earlier versions end here (and thus use no impulse response)
+
+    int32 savedImpulseResponsePathLength = 0;
+    if ( state->read( &savedImpulseResponsePathLength, sizeof ( int32 )) != kResultOk )
+        savedImpulseResponsePathLength = 0;
+
 #if BYTEORDER == kBigEndian
 
 // --- AUTO-GENERATED SETSTATE SWAP START
@@ -395,6 +547,7 @@ tresult PLUGIN_API Darvaza::setState( IBStream* state )
 // --- AUTO-GENERATED SETSTATE SWAP END
 
     SWAP_32( savedBypass );
+    SWAP_32( savedImpulseResponsePathLength );
 
 #endif
 
@@ -416,7 +569,85 @@ tresult PLUGIN_API Darvaza::setState( IBStream* state )
 
     _bypass = savedBypass > 0;
 
+    std::string savedImpulseResponsePath;
+    if ( savedImpulseResponsePathLength > 0 && savedImpulseResponsePathLength <= MAX_PATH_LENGTH ) {
+        savedImpulseResponsePath.resize( savedImpulseResponsePathLength );
+        if ( state->read( &savedImpulseResponsePath[ 0 ], savedImpulseResponsePathLength ) != kResultOk )
+            savedImpulseResponsePath.clear();
+    }
+    if ( !loadImpulseResponse( savedImpulseResponsePath ))
+        loadImpulseResponse( "" ); // unavailable response, fall back to the algorithmic reverb
+
+    // the sidechain gate properties were added to the state at a later stage, states
+    // saved by earlier versions end before these (and thus use the LFO gate mode)
+
+    float savedGateMode           = 0.f;
+    float savedSideChainAttack    = fSideChainAttack;
+    float savedSideChainRelease   = fSideChainRelease;
+    float savedSideChainThreshold = fSideChainThreshold;
+
+    if ( state->read( &savedGateMode, sizeof( float )) == kResultOk &&
+         state->read( &savedSideChainAttack, sizeof( float )) == kResultOk &&
+         state->read( &savedSideChainRelease, sizeof( float )) == kResultOk &&
+         state->read( &savedSideChainThreshold, sizeof( float )) == kResultOk )
+    {
+#if BYTEORDER == kBigEndian
+        SWAP_32( savedGateMode );
+        SWAP_32( savedSideChainAttack );
+        SWAP_32( savedSideChainRelease );
+        SWAP_32( savedSideChainThreshold );
+#endif
+        fGateMode           = savedGateMode;
+        fSideChainAttack    = savedSideChainAttack;
+        fSideChainRelease   = savedSideChainRelease;
+        fSideChainThreshold = savedSideChainThreshold;
+    } else {
+        fGateMode = 0.f;
+    }
+
+    // the limiter mode was added to the state at a later stage, states saved by earlier versions
+    // end before it. These load in the CLASSIC mode (the zero latency limiter of those versions) so
+    // existing projects keep their latency and output, only new instances default to TRUE_PEAK
+
+    float savedLimiterMode = 0.f;
+
+    if ( state->read( &savedLimiterMode, sizeof( float )) == kResultOk ) {
+#if BYTEORDER == kBigEndian
+        SWAP_32( savedLimiterMode );
+#endif
+    } else {
+        savedLimiterMode = 0.f;
+    }
+    fLimiterMode = savedLimiterMode;
+
+    // as is the reverb engine (states saved by earlier versions use the FREEVERB engine)
+
+    float savedReverbEngine = 0.f;
+
+    if ( state->read( &savedReverbEngine, sizeof( float )) == kResultOk ) {
+#if BYTEORDER == kBigEndian
+        SWAP_32( savedReverbEngine );
+#endif
+    } else {
+        savedReverbEngine = 0.f;
+    }
+    fReverbEngine = savedReverbEngine;
+
+    // as is the quality mode (states saved by earlier versions select it automatically)
+
+    float savedQualityMode = 0.f;
+
+    if ( state->read( &savedQualityMode, sizeof( float )) == kResultOk ) {
+#if BYTEORDER == kBigEndian
+        SWAP_32( savedQualityMode );
+#endif
+    } else {
+        savedQualityMode = 0.f;
+    }
+    fQualityMode = savedQualityMode;
+
     syncModel();
+    checkLatency();
 
     // Example of using the IStreamAttributes interface
     FUnknownPtr<IStreamAttributes> stream (state);
@@ -473,6 +704,7 @@ tresult PLUGIN_API Darvaza::getState( IBStream* state )
 // --- AUTO-GENERATED GETSTATE END
 
     int32 toSaveBypass = _bypass ? 1 : 0;
+    int32 toSaveImpulseResponsePathLength = ( int32 ) _impulseResponsePath.size();
 
 #if BYTEORDER == kBigEndian
 
@@ -493,6 +725,7 @@ tresult PLUGIN_API Darvaza::getState( IBStream* state )
 // --- AUTO-GENERATED GETSTATE SWAP END
 
     SWAP_32( toSaveBypass );
+    SWAP_32( toSaveImpulseResponsePathLength );
 
 #endif
 
@@ -513,6 +746,59 @@ tresult PLUGIN_API Darvaza::getState( IBStream* state )
 // --- AUTO-GENERATED GETSTATE APPLY END
 
     state->write( &toSaveBypass, sizeof( int32 ));
+    state->write( &toSaveImpulseResponsePathLength, sizeof( int32 ));
+
+    if ( !_impulseResponsePath.empty() )
+        state->write(( void* ) _impulseResponsePath.c_str(), ( int32 ) _impulseResponsePath.size() );
+
+    // the sidechain gate properties follow the impulse response path
+
+    float toSaveGateMode           = fGateMode;
+    float toSaveSideChainAttack    = fSideChainAttack;
+    float toSaveSideChainRelease   = fSideChainRelease;
+    float toSaveSideChainThreshold = fSideChainThreshold;
+
+#if BYTEORDER == kBigEndian
+    SWAP_32( toSaveGateMode );
+    SWAP_32( toSaveSideChainAttack );
+    SWAP_32( toSaveSideChainRelease );
+    SWAP_32( toSaveSideChainThreshold );
+#endif
+
+    state->write( &toSaveGateMode,           sizeof( float ));
+    state->write( &toSaveSideChainAttack,    sizeof( float ));
+    state->write( &toSaveSideChainRelease,   sizeof( float ));
+    state->write( &toSaveSideChainThreshold, sizeof( float ));
+
+    // the limiter mode follows the sidechain gate properties
+
+    float toSaveLimiterMode = fLimiterMode;
+
+#if BYTEORDER == kBigEndian
+    SWAP_32( toSaveLimiterMode );
+#endif
+
+    state->write( &toSaveLimiterMode, sizeof( float ));
+
+    // followed by the reverb engine
+
+    float toSaveReverbEngine = fReverbEngine;
+
+#if BYTEORDER == kBigEndian
+    SWAP_32( toSaveReverbEngine );
+#endif
+
+    state->write( &toSaveReverbEngine, sizeof( float ));
+
+    // followed by the quality mode
+
+    float toSaveQualityMode = fQualityMode;
+
+#if BYTEORDER == kBigEndian
+    SWAP_32( toSaveQualityMode );
+#endif
+
+    state->write( &toSaveQualityMode, sizeof( float ));
 
     return kResultOk;
 }
@@ -525,9 +811,23 @@ tresult PLUGIN_API Darvaza::setupProcessing( ProcessSetup& newSetup )
     // here we keep a trace of the processing mode (offline,...) for example.
     currentProcessMode = newSetup.processMode;
 
-    VST::SAMPLE_RATE = newSetup.sampleRate;
+    processingContext.sampleRate   = ( float ) newSetup.sampleRate;
+    processingContext.maxBlockSize = newSetup.maxSamplesPerBlock;
+    processingContext.processMode  = newSetup.processMode;
 
-    syncModel();
+    VST::SAMPLE_RATE = processingContext.sampleRate;
+
+    if ( pluginProcess == nullptr ) {
+        createPluginProcess();
+    } else {
+        pluginProcess->setProcessingContext( processingContext );
+#ifdef DARVAZA_NULL_TEST
+        pluginProcess->deadlineMonitor->enableGovernor( false ); // the reference isn't governed either
+        nullTest->setProcessingContext( processingContext );
+#endif
+        syncModel();
+    }
+    checkLatency(); // the latency is expressed in samples
 
     return AudioEffect::setupProcessing( newSetup );
 }
@@ -542,19 +842,28 @@ tresult PLUGIN_API Darvaza::setBusArrangements( SpeakerArrangement* inputs,  int
         return AudioEffect::setBusArrangements( inputs, numIns, outputs, numOuts ); // solves auval 4099 error
     }
 #endif
-    if ( numIns == 1 && numOuts == 1 )
+    // the second input is the sidechain, which can be mono or stereo
+
+    SpeakerArrangement sideChain = SpeakerArr::kStereo;
+    if ( numIns == 2 ) {
+        int32 sideChainChannels = SpeakerArr::getChannelCount( inputs[ 1 ]);
+        if ( sideChainChannels == 1 || sideChainChannels == 2 ) {
+            sideChain = inputs[ 1 ];
+        }
+    }
+
+    if (( numIns == 1 || numIns == 2 ) && numOuts == 1 )
     {
         if ( isMonoInOut )
         {
             AudioBus* bus = FCast<AudioBus>( audioInputs.at( 0 ));
+            AudioBus* sideChainBus = audioInputs.size() > 1 ? FCast<AudioBus>( audioInputs.at( 1 )) : nullptr;
             if ( bus )
             {
                 // check if we are Mono => Mono, if not we need to recreate the buses
-                if ( bus->getArrangement() != inputs[ 0 ])
+                if ( bus->getArrangement() != inputs[ 0 ] || ( sideChainBus && sideChainBus->getArrangement() != sideChain ))
                 {
-                    removeAudioBusses();
-                    addAudioInput ( STR16( "Mono In" ),  inputs [ 0 ] );
-                    addAudioOutput( STR16( "Mono Out" ), outputs[ 0 ] );
+                    createBuses( inputs[ 0 ], outputs[ 0 ], sideChain );
                 }
                 return kResultOk;
             }
@@ -568,18 +877,14 @@ tresult PLUGIN_API Darvaza::setBusArrangements( SpeakerArrangement* inputs,  int
                 // the host wants 2->2 (could be LsRs -> LsRs)
                 if ( isStereoInOut )
                 {
-                    removeAudioBusses();
-                    addAudioInput  ( STR16( "Stereo In"),  inputs [ 0 ] );
-                    addAudioOutput ( STR16( "Stereo Out"), outputs[ 0 ]);
-                    
+                    createBuses( inputs[ 0 ], outputs[ 0 ], sideChain );
+
                     return kResultTrue;
                 }
                 // the host want something different than 1->1 or 2->2 : in this case we want stereo
                 else if ( bus->getArrangement() != SpeakerArr::kStereo )
                 {
-                    removeAudioBusses();
-                    addAudioInput ( STR16( "Stereo In"),  SpeakerArr::kStereo );
-                    addAudioOutput( STR16( "Stereo Out"), SpeakerArr::kStereo );
+                    createBuses( SpeakerArr::kStereo, SpeakerArr::kStereo, SpeakerArr::kStereo );
 
                     return kResultFalse;
                 }
@@ -589,6 +894,20 @@ tresult PLUGIN_API Darvaza::setBusArrangements( SpeakerArrangement* inputs,  int
     return kResultFalse;
 }
 
+//------------------------------------------------------------------------
+void Darvaza::createBuses( SpeakerArrangement input, SpeakerArrangement output, SpeakerArrangement sideChain )
+{
+    bool isMono = SpeakerArr::getChannelCount( input ) == 1;
+
+    removeAudioBusses();
+    addAudioInput ( isMono ? STR16( "Mono In" )  : STR16( "Stereo In" ),  input );
+    addAudioOutput( isMono ? STR16( "Mono Out" ) : STR16( "Stereo Out" ), output );
+
+    // the sidechain is an auxiliary bus that is inactive until enabled by the host
+
+    addAudioInput( STR16( "Sidechain In" ), sideChain, kAux, 0 );
+}
+
 //------------------------------------------------------------------------
 tresult PLUGIN_API Darvaza::canProcessSampleSize( int32 symbolicSampleSize )
 {
@@ -624,23 +943,224 @@ tresult PLUGIN_API Darvaza::notify( IMessage* message )
         }
     }
 
+    // the controller polls the meter values at UI rate, reply with the last published values
+
+    if ( !strcmp( message->getMessageID(), "MeterRequest" ))
+    {
+        // we are in UI thread
+        Igorski::Meter::Values meterValues = pluginProcess != nullptr ? pluginProcess->meter->read() : Igorski::Meter::Values();
+        Igorski::DeadlineMonitor::State deadlineState = pluginProcess != nullptr ? pluginProcess->deadlineMonitor->read() : Igorski::DeadlineMonitor::State();
+        int qualityTier = pluginProcess != nullptr ? pluginProcess->getQualityTier() : Igorski::PluginProcess::QualityTiers::FULL_QUALITY;
+
+        if ( IPtr<IMessage> reply = owned( allocateMessage()))
+        {
+            reply->setMessageID( "MeterData" );
+            reply->getAttributes()->setFloat( "InputPeak",     meterValues.inputPeak );
+            reply->getAttributes()->setFloat( "InputRMS",      meterValues.inputRMS );
+            reply->getAttributes()->setFloat( "OutputPeak",    meterValues.outputPeak );
+            reply->getAttributes()->setFloat( "OutputRMS",     meterValues.outputRMS );
+            reply->getAttributes()->setFloat( "GainReduction", meterValues.gainReduction );
+            reply->getAttributes()->setFloat( "ProcessLoad",   deadlineState.load );
+            reply->getAttributes()->setInt( "QualityTier",     qualityTier );
+            reply->getAttributes()->setInt( "NearMisses",      deadlineState.nearMisses );
+            reply->getAttributes()->setInt( "Overruns",        deadlineState.overruns );
+            sendMessage( reply );
+        }
+        return kResultOk;
+    }
+
+#ifdef DARVAZA_PROFILE
+    // the controller polls the profiler statistics, reply with the timings (in microseconds) of the blocks
+    // processed since the previous request along with the time available for processing a block
+
+    if ( !strcmp( message->getMessageID(), "ProfileRequest" ))
+    {
+        if ( pluginProcess == nullptr )
+            return kResultFalse;
+
+        // we are in UI thread
+        Igorski::Profiler::Statistics statistics = pluginProcess->profiler->readStatistics();
+
+        if ( IPtr<IMessage> reply = owned( allocateMessage()))
+        {
+            IAttributeList* attributes = reply->getAttributes();
+            char attributeId[ 64 ];
+
+            reply->setMessageID( "ProfileData" );
+            attributes->setInt( "Blocks",          statistics.blocks );
+            attributes->setInt( "DroppedBlocks",   statistics.droppedBlocks );
+            attributes->setFloat( "BufferSize",    statistics.meanBufferSize );
+            attributes->setFloat( "BlockBudget",   statistics.meanBufferSize / processingContext.sampleRate * 1000000.f );
+            attributes->setFloat( "MeanBlockTime", statistics.meanBlockTime );
+            attributes->setFloat( "MaxBlockTime",  statistics.maxBlockTime );
+
+            for ( int i = 0; i < Igorski::Profiler::AMOUNT_OF_STAGES; ++i ) {
+                snprintf( attributeId, sizeof( attributeId ), "MeanTime.%s", Igorski::Profiler::STAGE_NAMES[ i ]);
+                attributes->setFloat( attributeId, statistics.meanStageTimes[ i ]);
+
+                snprintf( attributeId, sizeof( attributeId ), "MaxTime.%s", Igorski::Profiler::STAGE_NAMES[ i ]);
+                attributes->setFloat( attributeId, statistics.maxStageTimes[ i ]);
+            }
+            sendMessage( reply );
+        }
+        return kResultOk;
+    }
+#endif
+
+    // the controller requests loading of an impulse response for the convolution reverb, the
+    // path is provided as UTF-8 encoded binary data (an empty path removes the impulse response)
+
+    if ( !strcmp( message->getMessageID(), "LoadImpulseResponse" ))
+    {
+        const void* data;
+        uint32 size;
+        if ( message->getAttributes ()->getBinary( "Path", data, size ) == kResultOk && size <= MAX_PATH_LENGTH )
+        {
+            // we are in UI thread
+            bool loaded = loadImpulseResponse( std::string(( const char* ) data, size ));
+            return ( loaded || size == 0 ) ? kResultOk : kResultFalse;
+        }
+        return kInvalidArgument;
+    }
+
     return AudioEffect::notify( message );
 }
 
+bool Darvaza::loadImpulseResponse( const std::string& path )
+{
+    if ( path.empty() ) {
+        _impulseResponsePath.clear();
+        if ( pluginProcess != nullptr ) {
+            pluginProcess->clearImpulseResponse();
+            pluginProcess->setReverbEngine( PluginProcess::toReverbEngine( fReverbEngine ));
+#ifdef DARVAZA_NULL_TEST
+            nullTest->reference->clearImpulseResponse();
+            nullTest->reference->setReverbEngine( PluginProcess::toReverbEngine( fReverbEngine ));
+#endif
+        }
+        return false;
+    }
+
+    // without a PluginProcess the path is stored and the impulse
+    // response is read upon its creation (see createPluginProcess())
+
+    if ( pluginProcess == nullptr ) {
+        _impulseResponsePath = path;
+        return true;
+    }
+
+    if ( !pluginProcess->loadImpulseResponse( path.c_str() )) {
+        fprintf( stderr, "[Darvaza] could not read impulse response: %s\n", path.c_str() );
+        return false;
+    }
+    _impulseResponsePath = path;
+    pluginProcess->setReverbEngine( PluginProcess::ReverbEngines::CONVOLUTION );
+#ifdef DARVAZA_NULL_TEST
+    nullTest->reference->loadImpulseResponse( path.c_str() );
+    nullTest->reference->setReverbEngine( PluginProcess::ReverbEngines::CONVOLUTION );
+#endif
+
+    return true;
+}
+
+//------------------------------------------------------------------------
+uint32 PLUGIN_API Darvaza::getLatencySamples()
+{
+    // calculated from the model rather than read from the PluginProcess, as the host
+    // can request the latency before the PluginProcess has been created
+
+    _reportedLatency = Igorski::PluginProcess::calculateLatency(
+        Igorski::PluginProcess::toLimiterMode( fLimiterMode ), processingContext.sampleRate
+    );
+    return ( uint32 ) _reportedLatency;
+}
+
+void Darvaza::checkLatency()
+{
+    // the processor cannot restart the component, request the controller to notify the host (which
+    // requests the new latency). Note this is invoked outside of the audio thread, changes of
+    // the limiter mode parameter are reported to the host by the controller itself
+
+    int32 latency = Igorski::PluginProcess::calculateLatency(
+        Igorski::PluginProcess::toLimiterMode( fLimiterMode ), processingContext.sampleRate
+    );
+
+    if ( _reportedLatency < 0 || latency == _reportedLatency )
+        return;
+
+    if ( IPtr<IMessage> message = owned( allocateMessage()))
+    {
+        message->setMessageID( "LatencyChanged" );
+        sendMessage( message );
+    }
+}
+
+void Darvaza::createPluginProcess()
+{
+    if ( pluginProcess != nullptr )
+        return;
+
+    pluginProcess = new PluginProcess( 2, processingContext );
+
+#ifdef DARVAZA_NULL_TEST
+    // the reference is created alongside (and receives the same updates as) the pluginProcess, neither
+    // is governed by the deadline monitor as its quality tiers depend on timing
+
+    nullTest = new Igorski::NullTest( 2, processingContext );
+    pluginProcess->deadlineMonitor->enableGovernor( false );
+#endif
+
+#ifdef DARVAZA_PROFILE
+    // a trace of all processed blocks is recorded when a destination file is provided,
+    // it is written when the processor is deactivated (e.g. at the end of an offline render)
+
+    pluginProcess->profiler->setTraceRecording( getenv( "DARVAZA_PROFILE_TRACE" ) != nullptr );
+#endif
+
+    // apply the impulse response and model values restored while there was no PluginProcess
+
+    if ( !loadImpulseResponse( _impulseResponsePath ))
+        loadImpulseResponse( "" ); // unavailable response, fall back to the algorithmic reverb
+
+    syncModel();
+}
+
 void Darvaza::syncModel()
 {
     // forward the protected model values onto the plugin process and related processors
     // NOTE: when dealing with "bool"-types, use Calc::toBool() to determine on/off
-    pluginProcess->createGateTables( fWaveform ); // should come before gate speed updates
-    pluginProcess->setGateSpeed( fOddSpeed, fEvenSpeed, Calc::toBool( fLinkGates ));
-    pluginProcess->randomizeGateSpeed( fRandomSpeed );
-    pluginProcess->bitCrusher->setAmount( fBitDepth );
-    pluginProcess->setResampleRate( fResampleRate );
-    pluginProcess->setPlaybackRate( fPlaybackRate );
-    pluginProcess->enableReverse( Calc::toBool( fReverse ));
-    pluginProcess->setHarmony( fHarmonize );
-    pluginProcess->enableReverb( Calc::toBool( fReverb ));
-    pluginProcess->setDryMix( fDryMix );
+    if ( pluginProcess == nullptr )
+        return; // applied upon creation (see createPluginProcess())
+
+    syncProcess( pluginProcess );
+#ifdef DARVAZA_NULL_TEST
+    syncProcess( nullTest->reference );
+#endif
+}
+
+void Darvaza::syncProcess( Igorski::PluginProcess* process )
+{
+    process->createGateTables( fWaveform ); // should come before gate speed updates
+    process->setGateSpeed( fOddSpeed, fEvenSpeed, Calc::toBool( fLinkGates ));
+    process->randomizeGateSpeed( fRandomSpeed );
+    process->bitCrusher->setAmount( fBitDepth );
+    process->setResampleRate( fResampleRate );
+    process->setPlaybackRate( fPlaybackRate );
+    process->enableReverse( Calc::toBool( fReverse ));
+    process->setHarmony( fHarmonize );
+    process->enableReverb( Calc::toBool( fReverb ));
+    process->setDryMix( fDryMix );
+    process->setGateMode( fGateMode );
+    process->setSideChainAttack( fSideChainAttack );
+    process->setSideChainRelease( fSideChainRelease );
+    process->setSideChainThreshold( fSideChainThreshold );
+    process->setLimiterMode( fLimiterMode );
+    process->setQualitySelection( fQualityMode );
+
+    // the convolution engine remains selected for as long as an impulse response is loaded
+
+    if ( process->getReverbEngine() != Igorski::PluginProcess::ReverbEngines::CONVOLUTION )
+        process->setReverbEngine( Igorski::PluginProcess::toReverbEngine( fReverbEngine ));
 }
 
 }
@@ -25,7 +25,9 @@
 
 #include "public.sdk/source/vst/vstaudioeffect.h"
 #include "plugin_process.h"
+#include "nulltest.h"
 #include "global.h"
+#include <string>
 
 using namespace Steinberg::Vst;
 
@@ -82,6 +84,9 @@ class Darvaza : public AudioEffect
         /** We want to receive message. */
         tresult PLUGIN_API notify( IMessage* message ) SMTG_OVERRIDE;
 
+        /** Reports the latency introduced by the lookahead limiter. */
+        uint32 PLUGIN_API getLatencySamples() SMTG_OVERRIDE;
+
     protected:
 
         // our model values, these are all 0 - 1 range
@@ -103,17 +108,68 @@ class Darvaza : public AudioEffect
 
 // --- AUTO-GENERATED END
 
-        // float outputGainOld; // for visualizing output gain in DAW
+        // sidechain gate (stored after the impulse response path in the state)
+
+        float fGateMode            = 0.f;   // LFO
+        float fSideChainAttack     = .667f; // 10 ms
+        float fSideChainRelease    = .5f;   // 100 ms
+        float fSideChainThreshold  = .333f; // -40 dB
+
+        // output limiter (stored after the sidechain gate in the state)
+
+        float fLimiterMode = 1.f; // TRUE_PEAK
+
+        // algorithmic reverb engine (stored after the limiter mode in the state)
+
+        float fReverbEngine = 0.f; // FREEVERB
+
+        // quality mode selection (stored after the reverb engine in the state)
+
+        float fQualityMode = 0.f; // AUTOMATIC_QUALITY
+
+        Igorski::Meter::Values _lastMeterValues; // last meter values reported to the host
+        float _lastProcessLoad = 0.f;            // last deadline monitor state reported to the host
+        int   _lastQualityTier = Igorski::PluginProcess::QualityTiers::FULL_QUALITY;
         bool _bypass = false;
 
         int32 currentProcessMode;
-        Igorski::PluginProcess* pluginProcess;
+        Igorski::ProcessingContext processingContext; // sample rate, block size and mode of this instance
+        Igorski::PluginProcess* pluginProcess; // created lazily, nullptr until setupProcessing() or setActive()
+
+#ifdef DARVAZA_NULL_TEST
+        Igorski::NullTest* nullTest = nullptr; // renders the reference output, created along with the pluginProcess
+#endif
 
         bool isPlaying = false;
 
+        // the latency last reported to the host (-1 when not yet reported), when the sample rate or restored
+        // limiter mode change it, the controller is requested to notify the host (see checkLatency())
+
+        int32 _reportedLatency = -1;
+        void checkLatency();
+
         // synchronize the processors model with UI led changes
 
         void syncModel();
+        void syncProcess( Igorski::PluginProcess* process );
+
+        // creates the PluginProcess for the current processing context, when not yet existing
+
+        void createPluginProcess();
+
+        void writeOutputParameter( IParameterChanges* changes, ParamID id, float value );
+
+        // (re)creates the main audio buses for given arrangements along with the
+        // (optional and by default inactive) sidechain input bus
+
+        void createBuses( SpeakerArrangement input, SpeakerArrangement output, SpeakerArrangement sideChain );
+
+        // path of the impulse response used by the convolution reverb (empty when using the
+        // algorithmic reverb). Returns whether the impulse response at given path was loaded
+
+        static const int32 MAX_PATH_LENGTH = 4096;
+        std::string _impulseResponsePath;
+        bool loadImpulseResponse( const std::string& path );
 };
 
 }
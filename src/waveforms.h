@@ -27,51 +27,218 @@ namespace Igorski {
 namespace VST {
 
     static const int TABLE_SIZE = 512;
-    static const float WAVEFORM_CACHE_SAMPLE_RATE = 48000.f;
 
-    // these tables were generated by wavegenerator for
-    // the above table size and the above mentioned sample rate
+    // tables are band limited for the highest note the generator supports (in Hz)
+    // the amount of partials summed thus depends on the Nyquist frequency of the sample rate
 
-    static const float TABLE_SINE[ TABLE_SIZE ] =
-    {
-        0, 0.0188929, 0.0377786, 0.0566502, 0.0755004, 0.0943222, 0.113109, 0.131852, 0.150546, 0.169184, 0.187758, 0.206262, 0.224688, 0.243029, 0.26128, 0.279433, 0.297481, 0.315417, 0.333236, 0.35093, 0.368493, 0.385919, 0.403201, 0.420332, 0.437308, 0.454121, 0.470765, 0.487235, 0.503524, 0.519628, 0.535539, 0.551254, 0.566765, 0.582068, 0.597157, 0.612028, 0.626674, 0.641092, 0.655277, 0.669223, 0.682926, 0.696381, 0.709585, 0.722533, 0.73522, 0.747644, 0.7598, 0.771684, 0.783293, 0.794623, 0.805671, 0.816435, 0.82691, 0.837094, 0.846985, 0.856579, 0.865875, 0.87487, 0.883562, 0.891948, 0.900028, 0.907799, 0.91526, 0.92241, 0.929247, 0.93577, 0.941978, 0.947871, 0.953447, 0.958707, 0.96365, 0.968276, 0.972584, 0.976576, 0.980251, 0.98361, 0.986652, 0.98938, 0.991794, 0.993895, 0.995684, 0.997162, 0.998331, 0.999192, 0.999748, 1, 0.99995, 0.9996, 0.998953, 0.998011, 0.996776, 0.995251, 0.99344, 0.991344, 0.988968, 0.986313, 0.983385, 0.980185, 0.976718, 0.972987, 0.968995, 0.964748, 0.960248, 0.9555, 0.950508, 0.945276, 0.939809, 0.934111, 0.928187, 0.92204, 0.915677, 0.909102, 0.902319, 0.895334, 0.888151, 0.880776, 0.873214, 0.865469, 0.857549, 0.849456, 0.841198, 0.832779, 0.824205, 0.815481, 0.806613, 0.797607, 0.788468, 0.779201, 0.769813, 0.760309, 0.750695, 0.740976, 0.731158, 0.721248, 0.71125, 0.70117, 0.691015, 0.680789, 0.670499, 0.66015, 0.649749, 0.6393, 0.628809, 0.618282, 0.607724, 0.597142, 0.58654, 0.575924, 0.565299, 0.554671, 0.544046, 0.533428, 0.522823, 0.512235, 0.501671, 0.491134, 0.480631, 0.470165, 0.459743, 0.449368, 0.439045, 0.428779, 0.418574, 0.408435, 0.398366, 0.388372, 0.378456, 0.368623, 0.358876, 0.349221, 0.339659, 0.330196, 0.320834, 0.311577, 0.302428, 0.293391, 0.284469, 0.275665, 0.266981, 0.258421, 0.249987, 0.241682, 0.233508, 0.225468, 0.217563, 0.209796, 0.202169, 0.194683, 0.187341, 0.180143, 0.173092, 0.166188, 0.159434, 0.152829, 0.146374, 0.140072, 0.133922, 0.127924, 0.122081, 0.11639, 0.110854, 0.105471, 0.100242, 0.0951666, 0.0902445, 0.0854753, 0.0808582, 0.0763927, 0.072078, 0.067913, 0.0638968, 0.0600281, 0.0563058, 0.0527283, 0.0492941, 0.0460017, 0.0428493, 0.039835, 0.0369569, 0.0342129, 0.0316007, 0.0291183, 0.0267631, 0.0245328, 0.0224247, 0.0204362, 0.0185645, 0.0168068, 0.0151601, 0.0136215, 0.0121878, 0.0108558, 0.00962236, 0.00848403, 0.00743748, 0.00647918, 0.00560565, 0.00481322, 0.00409825, 0.00345703, 0.00288573, 0.00238055, 0.0019376, 0.00155292, 0.00122258, 0.000942512, 0.000708685, 0.000517003, 0.000363342, 0.000243549, 0.000153449, 8.8838e-05, 4.55002e-05, 1.92026e-05, 5.6911e-06, 7.11926e-07, -5.46985e-15, -7.11926e-07, -5.6911e-06, -1.92026e-05, -4.55002e-05, -8.8838e-05, -0.000153449, -0.000243555, -0.000363342, -0.000517003, -0.000708691, -0.000942512, -0.00122258, -0.00155294, -0.00193761, -0.00238057, -0.00288574, -0.00345703, -0.00409826, -0.00481322, -0.00560565, -0.0064792, -0.0074375, -0.00848406,
-        -0.00962236, -0.0108558, -0.0121878, -0.0136215, -0.0151601, -0.0168068, -0.0185645, -0.0204362, -0.0224247, -0.0245328, -0.0267632, -0.0291183, -0.0316008, -0.0342129, -0.0369569, -0.039835, -0.0428493, -0.0460018, -0.0492942, -0.0527283, -0.0563058, -0.0600281, -0.0638968, -0.0679131, -0.072078, -0.0763928, -0.0808583, -0.0854754, -0.0902446, -0.0951667, -0.100242, -0.105471, -0.110854, -0.11639, -0.122081, -0.127925, -0.133922, -0.140072, -0.146375, -0.152829, -0.159434, -0.166189,
-        -0.173092, -0.180143, -0.187341, -0.194683, -0.202169, -0.209796, -0.217563, -0.225468, -0.233508, -0.241682, -0.249987, -0.258421, -0.266981, -0.275665, -0.284469, -0.293391, -0.302428, -0.311577, -0.320833, -0.330195, -0.339659, -0.349221, -0.358877, -0.368623, -0.378456, -0.388372, -0.398366, -0.408435, -0.418574, -0.428779, -0.439045, -0.449367, -0.459743, -0.470165, -0.480631, -0.491134, -0.501671, -0.512235, -0.522823, -0.533428, -0.544046, -0.554672, -0.565299, -0.575924,
-        -0.58654, -0.597142, -0.607724, -0.618282, -0.628809, -0.6393, -0.649749, -0.660151, -0.670499, -0.680789, -0.691015, -0.701171, -0.71125, -0.721248, -0.731159, -0.740976, -0.750695, -0.760309, -0.769813, -0.779201, -0.788468, -0.797607, -0.806614, -0.815481, -0.824205, -0.832779, -0.841198, -0.849456, -0.857549, -0.865469, -0.873214, -0.880776, -0.888151, -0.895334, -0.902319, -0.909102, -0.915677, -0.922041, -0.928187, -0.934111, -0.939809, -0.945276, -0.950508, -0.9555, -0.960248,
-        -0.964748, -0.968995, -0.972987, -0.976718, -0.980185, -0.983385, -0.986313, -0.988968, -0.991344, -0.99344, -0.995251, -0.996776, -0.998011, -0.998953, -0.9996, -0.99995, -1, -0.999748, -0.999192, -0.998331, -0.997162, -0.995684, -0.993895, -0.991794, -0.98938, -0.986652, -0.98361, -0.980251, -0.976576, -0.972584, -0.968276, -0.96365, -0.958707, -0.953447, -0.94787, -0.941978, -0.93577, -0.929247, -0.92241, -0.91526, -0.907799, -0.900028, -0.891948, -0.883562, -0.87487, -0.865875,
-        -0.856579, -0.846985, -0.837094, -0.82691, -0.816434, -0.805671, -0.794623, -0.783293, -0.771684, -0.7598, -0.747644, -0.73522, -0.722533, -0.709585, -0.696381, -0.682925, -0.669222, -0.655276, -0.641092, -0.626674, -0.612027, -0.597157, -0.582068, -0.566765, -0.551253, -0.535539, -0.519628, -0.503524, -0.487235, -0.470765, -0.45412, -0.437307, -0.420332, -0.4032, -0.385918, -0.368493, -0.35093, -0.333236, -0.315417, -0.29748, -0.279432, -0.26128, -0.243029, -0.224687, -0.206261,
-        -0.187758, -0.169184, -0.150546, -0.131852, -0.113109, -0.0943222, -0.0755003, -0.0566501, -0.0377785, -0.0188927
-    };
+    static const int TABLE_BAND_LIMIT    = 11839;
+    static constexpr float TABLE_MAX_NYQUIST = 192000.f;
 
-    static const float TABLE_TRIANGLE[ TABLE_SIZE ] =
-    {
-        0.00389134, 0.016116, 0.0283389, 0.0405581, 0.0527718, 0.0649781, 0.0771752, 0.0893612, 0.101534, 0.113693, 0.125835, 0.137958, 0.150062, 0.162143, 0.174201, 0.186233, 0.198237, 0.210212, 0.222156, 0.234068, 0.245944, 0.257784, 0.269586, 0.281348, 0.293068, 0.304745, 0.316376, 0.32796, 0.339496, 0.35098, 0.362413, 0.373791, 0.385114, 0.39638, 0.407586, 0.418732, 0.429815, 0.440834, 0.451787, 0.462673, 0.473489, 0.484235, 0.494909, 0.505508, 0.516032, 0.526479, 0.536847, 0.547135, 0.557341, 0.567464, 0.577502, 0.587454, 0.597317, 0.607092, 0.616775, 0.626366, 0.635864, 0.645266, 0.654571, 0.663779, 0.672887, 0.681895, 0.6908, 0.699602, 0.7083, 0.716891, 0.725375, 0.73375, 0.742015, 0.750169, 0.75821, 0.766139, 0.773952, 0.781649, 0.789229, 0.796691, 0.804034, 0.811256, 0.818356, 0.825334, 0.832188, 0.838917, 0.845521, 0.851997, 0.858347, 0.864567, 0.870658, 0.876618, 0.882447, 0.888143, 0.893707, 0.899136, 0.904431, 0.90959, 0.914612, 0.919498, 0.924245, 0.928854, 0.933324, 0.937653, 0.941842, 0.94589, 0.949796, 0.953559, 0.95718, 0.960657, 0.963989, 0.967178, 0.970221, 0.973118, 0.97587, 0.978475, 0.980934, 0.983245, 0.985409, 0.987425, 0.989293, 0.991012, 0.992583, 0.994005, 0.995278, 0.996402, 0.997376, 0.9982, 0.998875, 0.9994, 0.999775, 1, 0.992292, 0.992217, 0.991992, 0.991617, 0.991092, 0.990418, 0.989593, 0.988619, 0.987495, 0.986223, 0.984801, 0.98323, 0.98151, 0.979642, 0.977626, 0.975462, 0.973151, 0.970692, 0.968087, 0.965336, 0.962438, 0.959395, 0.956207, 0.952874, 0.949397, 0.945777, 0.942013, 0.938107, 0.93406, 0.92987, 0.925541, 0.921071, 0.916462, 0.911715, 0.906829, 0.901807, 0.896648, 0.891353, 0.885924, 0.880361, 0.874664, 0.868835, 0.862875, 0.856784, 0.850564, 0.844215, 0.837738, 0.831134, 0.824405, 0.817551, 0.810573, 0.803473, 0.796251, 0.788908, 0.781446, 0.773866, 0.766169, 0.758356, 0.750428, 0.742386, 0.734232, 0.725967, 0.717592, 0.709108, 0.700517, 0.69182, 0.683018, 0.674112, 0.665105, 0.655996, 0.646789, 0.637483, 0.628081, 0.618583, 0.608992, 0.599309, 0.589534, 0.579671, 0.569719, 0.559681, 0.549559, 0.539352, 0.529064, 0.518696, 0.508249, 0.497725, 0.487126, 0.476452, 0.465706, 0.45489, 0.444004, 0.433051, 0.422032, 0.410949, 0.399803, 0.388597, 0.377331, 0.366009, 0.35463, 0.343198, 0.331713, 0.320177, 0.308593, 0.296962, 0.285286, 0.273565, 0.261804, 0.250002, 0.238161, 0.226285, 0.214374, 0.20243, 0.190454, 0.17845, 0.166418, 0.15436, 0.142279, 0.130176, 0.118052, 0.10591, 0.0937517, 0.0815785, 0.0693924, 0.0571952, 0.0449889, 0.0327754, 0.0205562, 0.00833331, 0.00389126, -0.00833349, -0.0205564, -0.0327756, -0.0449891, -0.0571954, -0.0693925, -0.0815786, -0.0937519, -0.10591, -0.118052, -0.130176, -0.142279, -0.154361, -0.166418, -0.17845, -0.190455, -0.20243, -0.214374, -0.226285, -0.238162, -0.250002, -0.261804, -0.273566, -0.285286, -0.296962, -0.308593, -0.320178, -0.331713, -0.343198, -0.35463, -0.366009, -0.377332,
-        -0.388597, -0.399804, -0.410949, -0.422032, -0.433051, -0.444004, -0.45489, -0.465706, -0.476452, -0.487126, -0.497725, -0.50825, -0.518696, -0.529065, -0.539353, -0.549559, -0.559682, -0.56972, -0.579671, -0.589535, -0.599309, -0.608992, -0.618584, -0.628081, -0.637483, -0.646789, -0.655997, -0.665105, -0.674112, -0.683018, -0.69182, -0.700517, -0.709108, -0.717592, -0.725967, -0.734232, -0.742386, -0.750428, -0.758356, -0.766169, -0.773866, -0.781447, -0.788908, -0.796251, -0.803473,
-        -0.810573, -0.817551, -0.824405, -0.831135, -0.837738, -0.844215, -0.850564, -0.856784, -0.862875, -0.868835, -0.874664, -0.880361, -0.885924, -0.891354, -0.896648, -0.901807, -0.90683, -0.911715, -0.916463, -0.921071, -0.925541, -0.92987, -0.93406, -0.938107, -0.942013, -0.945777, -0.949397, -0.952874, -0.956207, -0.959395, -0.962438, -0.965336, -0.968087, -0.970692, -0.973151, -0.975462, -0.977626, -0.979642, -0.98151, -0.98323, -0.984801, -0.986223, -0.987495, -0.988619, -0.989593,
-        -0.990418, -0.991092, -0.991617, -0.991992, -0.992217, -0.992292, -1, -0.999775, -0.9994, -0.998875, -0.9982, -0.997376, -0.996402, -0.995278, -0.994005, -0.992583, -0.991012, -0.989293, -0.987425, -0.985409, -0.983245, -0.980934, -0.978475, -0.97587, -0.973118, -0.970221, -0.967177, -0.963989, -0.960656, -0.95718, -0.953559, -0.949796, -0.94589, -0.941842, -0.937653, -0.933324, -0.928854, -0.924245, -0.919497, -0.914612, -0.90959, -0.904431, -0.899136, -0.893707, -0.888143, -0.882447,
-        -0.876618, -0.870658, -0.864567, -0.858347, -0.851997, -0.845521, -0.838917, -0.832188, -0.825334, -0.818356, -0.811255, -0.804034, -0.796691, -0.789229, -0.781649, -0.773952, -0.766138, -0.75821, -0.750169, -0.742015, -0.733749, -0.725374, -0.716891, -0.708299, -0.699602, -0.6908, -0.681895, -0.672887, -0.663779, -0.654571, -0.645266, -0.635863, -0.626366, -0.616775, -0.607091, -0.597317, -0.587453, -0.577502, -0.567464, -0.557341, -0.547135, -0.536847, -0.526479, -0.516032, -0.505508, -0.494908, -0.484235, -0.473489, -0.462672, -0.451787, -0.440833, -0.429814, -0.418731, -0.407586, -0.39638, -0.385114, -0.373791, -0.362413, -0.35098, -0.339495, -0.32796, -0.316376, -0.304745, -0.293068, -0.281348, -0.269586, -0.257784, -0.245944, -0.234068, -0.222156, -0.210212, -0.198237, -0.186233, -0.174201, -0.162143, -0.150062, -0.137958, -0.125835, -0.113693, -0.101534, -0.0893608, -0.0771752, -0.0649781, -0.0527717, -0.040558, -0.0283388, -0.0161159
-    };
+    // the gates play the tables at sub-audio rates (where the band limit can't be reached), so lower
+    // rates keep the partials of the 48 kHz tables the gates were designed with (below this amount,
+    // the saw and triangle would degrade into a sine)
 
-    static const float TABLE_SAW[ TABLE_SIZE ] =
-    {
-        0, 0.0167199, 0.0334349, 0.0501397, 0.0668295, 0.0834991, 0.100144, 0.116758, 0.133337, 0.149876, 0.16637, 0.182815, 0.199204, 0.215533, 0.231798, 0.247993, 0.264114, 0.280156, 0.296115, 0.311984, 0.327761, 0.34344, 0.359017, 0.374487, 0.389845, 0.405088, 0.420211, 0.435209, 0.450079, 0.464816, 0.479416, 0.493875, 0.508188, 0.522353, 0.536365, 0.550219, 0.563914, 0.577444, 0.590806, 0.603997, 0.617013, 0.629851, 0.642507, 0.654979, 0.667262, 0.679355, 0.691254, 0.702955, 0.714458, 0.725757, 0.736852, 0.74774, 0.758417, 0.768882, 0.779132, 0.789165, 0.79898, 0.808573, 0.817944, 0.82709, 0.836009, 0.844701, 0.853163, 0.861394, 0.869393, 0.877158, 0.884689, 0.891984, 0.899042, 0.905863, 0.912445, 0.918789, 0.924893, 0.930758, 0.936382, 0.941765, 0.946908, 0.95181, 0.956471, 0.960892, 0.965072, 0.969012, 0.972713, 0.976174, 0.979396, 0.982381, 0.985128, 0.987639, 0.989915, 0.991956, 0.993764, 0.99534, 0.996685, 0.997801, 0.998689, 0.99935, 0.999786, 1, 0.999992, 0.999765, 0.99932, 0.998659, 0.997785, 0.9967, 0.995405, 0.993904, 0.992198, 0.99029, 0.988182, 0.985876, 0.983377, 0.980685, 0.977804, 0.974737, 0.971486, 0.968054, 0.964444, 0.960659, 0.956702, 0.952576, 0.948284, 0.943829, 0.939214, 0.934444, 0.929519, 0.924445, 0.919224, 0.91386, 0.908355, 0.902713, 0.896939, 0.891034, 0.885002, 0.878847, 0.872573, 0.866182, 0.859678, 0.853065, 0.846346, 0.839524, 0.832603, 0.825586, 0.818478, 0.811281, 0.803998, 0.796634, 0.789191, 0.781673, 0.774084, 0.766426, 0.758704, 0.75092, 0.743078, 0.735181, 0.727232, 0.719235, 0.711193, 0.703108, 0.694985, 0.686826, 0.678635, 0.670413, 0.662165, 0.653894, 0.645601, 0.637291, 0.628965, 0.620627, 0.61228, 0.603926, 0.595567, 0.587207, 0.578848, 0.570491, 0.562141, 0.553799, 0.545467, 0.537148, 0.528843, 0.520556, 0.512287, 0.50404, 0.495815, 0.487615, 0.479443, 0.471298, 0.463184, 0.455101, 0.447051, 0.439037, 0.431058, 0.423117, 0.415215, 0.407353, 0.399532, 0.391754, 0.384019, 0.376328, 0.368682, 0.361082, 0.353529, 0.346023, 0.338565, 0.331156, 0.323796, 0.316485, 0.309224, 0.302013, 0.294852, 0.287742, 0.280682, 0.273672, 0.266713, 0.259805, 0.252946, 0.246137, 0.239378, 0.232668, 0.226007, 0.219395, 0.21283, 0.206312, 0.199841, 0.193416, 0.187036, 0.180701, 0.174409, 0.16816, 0.161952, 0.155785, 0.149658, 0.143569, 0.137518, 0.131503, 0.125523, 0.119577, 0.113663, 0.107781, 0.101929, 0.0961049, 0.0903082, 0.0845371, 0.0787902, 0.0730659, 0.0673629, 0.0616795, 0.0560143, 0.0503655, 0.0447315, 0.0391109, 0.0335018, 0.0279028, 0.0223122, 0.0167283, 0.0111494, 0.00557385, -3.97055e-08, -0.00557393, -0.0111495, -0.0167284, -0.0223123, -0.0279029, -0.0335019, -0.0391109, -0.0447316, -0.0503655, -0.0560144, -0.0616796, -0.067363, -0.073066, -0.0787902, -0.0845371, -0.0903082, -0.096105, -0.101929, -0.107781, -0.113663, -0.119577, -0.125523, -0.131503, -0.137518, -0.143569, -0.149658, -0.155785, -0.161952, -0.16816, -0.174409, -0.180701,
-        -0.187036, -0.193416, -0.199841, -0.206312, -0.21283, -0.219395, -0.226007, -0.232668, -0.239378, -0.246137, -0.252946, -0.259805, -0.266713, -0.273672, -0.280682, -0.287742, -0.294852, -0.302013, -0.309224, -0.316485, -0.323796, -0.331156, -0.338566, -0.346023, -0.353529, -0.361082, -0.368682, -0.376328, -0.384019, -0.391754, -0.399532, -0.407353, -0.415215, -0.423117, -0.431058, -0.439037, -0.447051, -0.455101, -0.463183, -0.471298, -0.479443, -0.487616, -0.495815, -0.50404,
-        -0.512287, -0.520556, -0.528843, -0.537148, -0.545467, -0.553799, -0.562141, -0.570492, -0.578848, -0.587207, -0.595567, -0.603926, -0.61228, -0.620628, -0.628965, -0.637291, -0.645601, -0.653894, -0.662165, -0.670413, -0.678635, -0.686826, -0.694985, -0.703108, -0.711193, -0.719235, -0.727232, -0.735181, -0.743078, -0.75092, -0.758704, -0.766426, -0.774084, -0.781673, -0.789191, -0.796634, -0.803998, -0.811281, -0.818478, -0.825587, -0.832603, -0.839524, -0.846346, -0.853065,
-        -0.859678, -0.866182, -0.872573, -0.878848, -0.885002, -0.891034, -0.896939, -0.902713, -0.908355, -0.91386, -0.919224, -0.924445, -0.929519, -0.934444, -0.939215, -0.943829, -0.948284, -0.952576, -0.956702, -0.960659, -0.964444, -0.968054, -0.971486, -0.974737, -0.977804, -0.980685, -0.983377, -0.985877, -0.988182, -0.99029, -0.992198, -0.993904, -0.995405, -0.9967, -0.997785, -0.998659, -0.99932, -0.999765, -0.999992, -1, -0.999786, -0.99935, -0.998689, -0.997801, -0.996685, -0.99534, -0.993764, -0.991956, -0.989915, -0.987639, -0.985128, -0.982381, -0.979396, -0.976174, -0.972713, -0.969012, -0.965072, -0.960892, -0.956471, -0.95181, -0.946908, -0.941765, -0.936382, -0.930757, -0.924893, -0.918789, -0.912445, -0.905863, -0.899042, -0.891983, -0.884688, -0.877158, -0.869392, -0.861394, -0.853163, -0.844701, -0.836009, -0.82709, -0.817944, -0.808573, -0.798979, -0.789165, -0.779132, -0.768881, -0.758417, -0.747739, -0.736852, -0.725757, -0.714458, -0.702955,
-        -0.691254, -0.679355, -0.667262, -0.654978, -0.642507, -0.629851, -0.617013, -0.603997, -0.590806, -0.577443, -0.563913, -0.550219, -0.536365, -0.522353, -0.508188, -0.493875, -0.479416, -0.464816, -0.450079, -0.435209, -0.420211, -0.405088, -0.389845, -0.374486, -0.359016, -0.34344, -0.327761, -0.311984, -0.296115, -0.280156, -0.264114, -0.247993, -0.231798, -0.215533, -0.199203, -0.182814, -0.16637, -0.149876, -0.133337, -0.116757, -0.100144, -0.0834991, -0.0668294, -0.0501396,
-        -0.0334347, -0.0167198
+    static const int TABLE_MIN_PARTIALS = 2;
+
+    // the sample rates for which the tables are generated at compile time, for all
+    // other rates the tables are rendered at runtime (see WaveGenerator)
+
+    static const int CACHED_SAMPLE_RATES_AMOUNT = 6;
+    inline constexpr float CACHED_SAMPLE_RATES[ CACHED_SAMPLE_RATES_AMOUNT ] = {
+        44100.f, 48000.f, 88200.f, 96000.f, 176400.f, 192000.f
     };
 
-    static const float TABLE_SQUARE[ TABLE_SIZE ] =
+    // waveform indices, these match the WaveGenerator::WaveForms enumeration
+
+    static const int WAVEFORM_SINE     = 0;
+    static const int WAVEFORM_TRIANGLE = 1;
+    static const int WAVEFORM_SAW      = 2;
+    static const int WAVEFORM_SQUARE   = 3;
+    static const int WAVEFORM_AMOUNT   = 4;
+
+    namespace WaveformMath
     {
-        0, 0.25, 0.5, 0.75, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
-        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0.75, 0.5, 0.25, 0,
-        -0.25, -0.5, -0.75, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -0.75, -0.5, -0.25, 0
+        static constexpr double PI     = 3.141592653589793;
+        static constexpr double TWO_PI = PI * 2.0;
+
+        // sine evaluated by its Taylor series (usable in constant expressions)
+
+        constexpr double sine( double x )
+        {
+            while ( x > PI ) {
+                x -= TWO_PI;
+            }
+            while ( x < -PI ) {
+                x += TWO_PI;
+            }
+            double term = x, sum = x;
+            for ( int n = 1; n < 14; ++n ) {
+                term *= -x * x / (( 2.0 * n ) * ( 2.0 * n + 1.0 ));
+                sum  += term;
+            }
+            return sum;
+        }
+
+        // the amount of partials a table is summed from for given sample rate
+
+        constexpr int getPartials( float sampleRate, int tableSize )
+        {
+            float nyquist = ( sampleRate < TABLE_MAX_NYQUIST * 2.f ? sampleRate : TABLE_MAX_NYQUIST * 2.f ) / 2.f;
+            int partials  = ( int ) ( nyquist / ( float ) TABLE_BAND_LIMIT );
+
+            // at least the minimum amount of partials, at most the highest frequency the table can represent
+
+            if ( partials < TABLE_MIN_PARTIALS ) {
+                partials = TABLE_MIN_PARTIALS;
+            }
+            if ( partials > tableSize / 2 - 1 ) {
+                partials = tableSize / 2 - 1;
+            }
+            return partials;
+        }
+
+        // the amplitude of given partial (1-based) of a waveform, smoothed to reduce Gibbs ringing
+
+        constexpr double getAmplitude( int waveform, int partial, int partials )
+        {
+            double gibbs = sine(( partial - 1.0 ) * PI / ( 2.0 * partials ) + PI / 2.0 ); // e.g. cosine
+            gibbs *= gibbs;
+
+            return ( waveform == WAVEFORM_SAW ) ? gibbs / partial : gibbs;
+        }
+
+        // sums the first partials of a waveform into output (directly, see WaveGenerator for a faster
+        // runtime alternative). sines holds a single sine cycle of tableSize length, as the partials
+        // are integer multiples of the table frequency, all their values can be looked up from it
+
+        template <typename T>
+        constexpr void sumPartials( int waveform, int partials, int tableSize, const T* sines, T* output )
+        {
+            double amplitudes[ TABLE_SIZE / 2 ] = {};
+            for ( int s = 1; s <= partials; ++s ) {
+                amplitudes[ s - 1 ] = getAmplitude( waveform, s, partials );
+            }
+
+            for ( int t = 0; t < tableSize; ++t ) {
+                double sample = 0.0;
+                for ( int s = 1, index = t; s <= partials; ++s, index += t ) {
+                    if ( index >= tableSize ) {
+                        index -= tableSize;
+                    }
+                    sample += amplitudes[ s - 1 ] * sines[ index ];
+                }
+                output[ t ] = ( T ) sample;
+            }
+        }
+
+        /**
+         * shapes the sum of all partials (full) into the final waveform. lower is the sum
+         * of all but the last partial (used by the triangle to determine its slope direction)
+         * the result is written into output (which may equal full)
+         */
+        template <typename T, typename O>
+        constexpr void shape( int waveform, int partials, int tableSize, const T* full, const T* lower, O* output )
+        {
+            double delta    = 1.0 / ( tableSize / 2.0 );
+            double maxValue = 0.0;
+
+            for ( int t = 0; t < tableSize; ++t ) {
+                double sample = full[ t ];
+                double value  = sample;
+
+                if ( waveform == WAVEFORM_TRIANGLE ) {
+                    // step towards the direction of the last partial
+                    double lastSample = ( partials > 1 ) ? ( double ) lower[ t ] : ( t > 0 ? ( double ) full[ t - 1 ] : 0.0 );
+                    value = lastSample + (( sample >= lastSample ) ? delta : -delta );
+                } else if ( waveform == WAVEFORM_SQUARE ) {
+                    // snap to extremes
+                    value = ( sample >= 0.0 ) ? 1.0 : -1.0;
+                }
+                output[ t ] = ( O ) value;
+
+                double absValue = value < 0.0 ? -value : value;
+                maxValue = absValue > maxValue ? absValue : maxValue;
+            }
+
+            if ( waveform == WAVEFORM_SQUARE ) {
+                // square waves are very violent, apply gentle fades around the start/end of the waveform
+                // and a ramp across the zero crossing in the middle of the cycle
+                int smoothRange = 4;
+                double factor   = 1.0 / smoothRange;
+                if ( tableSize >= ( smoothRange * 4 )) {
+                    int fadeOutPos = tableSize - smoothRange;
+                    int tableEnd   = tableSize - 1;
+                    int center     = tableSize / 2;
+                    for ( int j = 0; j < smoothRange; ++j ) {
+                        output[ j ] = ( O ) ( output[ j ] * ( j * factor ));
+                    }
+                    for ( int j = center - smoothRange + 1; j < center + smoothRange; ++j ) {
+                        output[ j ] = ( O ) (( center - j ) * factor );
+                    }
+                    for ( int j = fadeOutPos; j < tableSize; ++j ) {
+                        output[ j ] = ( O ) ( output[ j ] * (( tableEnd - j ) * factor ));
+                    }
+                }
+            } else if ( maxValue > 0.0 ) {
+                // normalize values for all other waveforms to keep them in the -1 to +1 range
+                double factor = 1.0 / maxValue;
+                for ( int j = 0; j < tableSize; ++j ) {
+                    output[ j ] = ( O ) ( output[ j ] * factor );
+                }
+            }
+        }
+
+        struct SineCycle {
+            double values[ TABLE_SIZE ];
+        };
+
+        constexpr SineCycle generateSineCycle()
+        {
+            SineCycle out = {};
+            for ( int t = 0; t < TABLE_SIZE; ++t ) {
+                out.values[ t ] = sine( TWO_PI * t / TABLE_SIZE );
+            }
+            // ensure the zero crossings are exact (to determine the sign of the square wave)
+            out.values[ 0 ] = out.values[ TABLE_SIZE / 2 ] = 0.0;
+
+            return out;
+        }
+
+        inline constexpr SineCycle SINE_CYCLE = generateSineCycle();
+
+        struct CachedWaveforms {
+            float tables[ WAVEFORM_AMOUNT ][ TABLE_SIZE ];
+        };
+
+        constexpr CachedWaveforms generateCachedWaveforms( float sampleRate )
+        {
+            CachedWaveforms out = {};
+            int partials = getPartials( sampleRate, TABLE_SIZE );
+
+            for ( int waveform = 0; waveform < WAVEFORM_AMOUNT; ++waveform ) {
+                double full[ TABLE_SIZE ]  = {};
+                double lower[ TABLE_SIZE ] = {};
+
+                sumPartials( waveform, partials, TABLE_SIZE, SINE_CYCLE.values, full );
+                if ( waveform == WAVEFORM_TRIANGLE && partials > 1 ) {
+                    sumPartials( waveform, partials - 1, TABLE_SIZE, SINE_CYCLE.values, lower );
+                }
+                shape( waveform, partials, TABLE_SIZE, full, lower, out.tables[ waveform ] );
+            }
+            return out;
+        }
+    }
+
+    // the tables for each cached sample rate (in order of CACHED_SAMPLE_RATES), generated at compile time
+
+    inline constexpr WaveformMath::CachedWaveforms CACHED_WAVEFORMS[ CACHED_SAMPLE_RATES_AMOUNT ] = {
+        WaveformMath::generateCachedWaveforms( CACHED_SAMPLE_RATES[ 0 ] ),
+        WaveformMath::generateCachedWaveforms( CACHED_SAMPLE_RATES[ 1 ] ),
+        WaveformMath::generateCachedWaveforms( CACHED_SAMPLE_RATES[ 2 ] ),
+        WaveformMath::generateCachedWaveforms( CACHED_SAMPLE_RATES[ 3 ] ),
+        WaveformMath::generateCachedWaveforms( CACHED_SAMPLE_RATES[ 4 ] ),
+        WaveformMath::generateCachedWaveforms( CACHED_SAMPLE_RATES[ 5 ] )
     };
 }
-};
+}
 #endif
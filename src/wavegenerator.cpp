@@ -24,136 +24,84 @@
  */
 #include "wavegenerator.h"
 #include "waveforms.h"
-#include <math.h>
-#include <cmath>
+#include "fft.h"
+#include <string.h>
+#include <vector>
 
 using namespace Igorski::VST;
 
 namespace Igorski {
 namespace WaveGenerator
 {
-    WaveTable* generate( WaveForms waveformType )
+    // renders the sum of the first partials of a waveform by placing their amplitudes in
+    // the spectrum and transforming it back into the time domain (tableSize must be a power of two)
+
+    static void renderPartials( FFT& fft, int waveformType, int partials, float* real, float* imag, float* output )
     {
-        WaveTable* waveTable = new WaveTable( TABLE_SIZE, 440.f );
-
-        float* outputBuffer = waveTable->getBuffer();
-
-        if ( VST::SAMPLE_RATE <= ( WAVEFORM_CACHE_SAMPLE_RATE * 2 )) {
-            // when the sample rate is in roughly the same ballpark as the cached tables we
-            // just assign the cached contents directly to the WaveTable and skip runtime
-            // rendering (as it is CPU heavy)
-            auto waveformTable = TABLE_SINE;
-            switch ( waveformType ) {
-                default:
-                    break;
-                case WaveForms::TRIANGLE:
-                    waveformTable = TABLE_TRIANGLE;
-                    break;
-                case WaveForms::SAWTOOTH:
-                    waveformTable = TABLE_SAW;
-                    break;
-                case WaveForms::SQUARE:
-                    waveformTable = TABLE_SQUARE;
-                    break;
-            }
+        int size = fft.size;
 
-            for ( int i = 0; i < TABLE_SIZE; i++ ) {
-                outputBuffer[ i ] = waveformTable[ i ];
-            }
-            return waveTable;
+        memset( real, 0, size * sizeof( float ));
+        memset( imag, 0, size * sizeof( float ));
+
+        // a sine of amplitude a at bin s equals a spectral component of -a * size / 2 on the imaginary axis
+
+        for ( int s = 1; s <= partials; ++s ) {
+            imag[ s ] = ( float ) ( -WaveformMath::getAmplitude( waveformType, s, partials ) * size / 2.0 );
         }
+        fft.inverseReal( real, imag, output );
+    }
+
+    WaveTable* generate( WaveForms waveformType, float sampleRate, int tableSize )
+    {
+        WaveTable* waveTable = new WaveTable( tableSize );
+        float* outputBuffer  = waveTable->getBuffer();
 
-        int tempValue, partials;
-        float frequency, gibbs, sample, tmp, maxValue;
-        float power, baseFrequency = 440;
-        // note we cap the max sample rate (the Steinberg validator test goes into million Hz territory...)
-        // for now it's safe to assume no VST will be used in gHz sampling rate projects...
-        float nyquist = fminf( 384000.f, VST::SAMPLE_RATE  ) / 2.f;
-
-        // every other MIDI note (127 values)
-        for ( int i = -69; i <= 58; i += 2 )
-        {
-            power       = i / 12.0;
-            tempValue   = baseFrequency * pow( 2, power );
-            frequency   = round( tempValue );
-            partials    = nyquist / frequency;
-            maxValue    = 0.0;
-
-            // unique to triangle generation
-
-            float delta      = 1.f / (( float ) TABLE_SIZE / 2 );
-            float lastSample = 0.0;
-
-            for ( int t = 0; t < TABLE_SIZE; t++ )
-            {
-                sample = 0.0, tmp = 0.0;
-
-                // summing of the Fourier series for harmonics up to half the sample rate (Nyquist frequency)
-                for ( int s = 1; s <= partials; ++s )
-                {
-                    // smoothing of sharp transitions
-                    gibbs  = cos(( float )( s - 1.0 ) * VST::PI / ( 2.0 * ( float ) partials ));
-                    gibbs *= gibbs;
-
-                    // generation of the waveform
-                    switch ( waveformType )
-                    {
-                        case WaveForms::SINE:
-                            sample += gibbs * sin(( float ) s * VST::TWO_PI * ( float ) t / TABLE_SIZE );
-                            tmp     = sample;
-                            break;
-
-                        case WaveForms::TRIANGLE:
-                            sample += gibbs * sin(( float ) s * VST::TWO_PI * ( float ) t / TABLE_SIZE );
-                            tmp     = lastSample + (( sample >= lastSample ) ? delta : -delta );
-                            break;
-
-                        case WaveForms::SAWTOOTH:
-                            sample += gibbs * ( 1.0 / ( float ) s ) * sin(( float ) s * VST::TWO_PI * ( float ) t / TABLE_SIZE );
-                            tmp     = sample;
-                            break;
-
-                        case WaveForms::SQUARE:
-                            // regular sine generation
-                            sample += gibbs * sin(( float ) s * VST::TWO_PI * ( float ) t / TABLE_SIZE );
-                            // snap to extremes
-                            tmp = ( sample >= 0.0 ) ? 1.0 : -1.0;
-                            break;
-                    }
-                    lastSample = sample;
+        // when the tables for the sample rate were generated at compile time, assign their contents directly
+
+        if ( tableSize == TABLE_SIZE ) {
+            for ( int i = 0; i < CACHED_SAMPLE_RATES_AMOUNT; ++i ) {
+                if ( CACHED_SAMPLE_RATES[ i ] == sampleRate ) {
+                    memcpy( outputBuffer, CACHED_WAVEFORMS[ i ].tables[ waveformType ], tableSize * sizeof( float ));
+                    return waveTable;
                 }
-                outputBuffer[ t ] = tmp;
+            }
+        }
+
+        // the table is band limited for the highest note (only the partials below the Nyquist frequency
+        // of the sample rate are summed). Note the sample rate is capped (the Steinberg validator test
+        // goes into million Hz territory...) for now it's safe to assume no VST will be used in gHz sampling rate projects...
+
+        int partials = WaveformMath::getPartials( sampleRate, tableSize );
+
+        std::vector<float> full( tableSize );
+        std::vector<float> lower( tableSize );
+        bool needsLower = waveformType == WaveForms::TRIANGLE && partials > 1;
+
+        if (( tableSize & ( tableSize - 1 )) == 0 ) {
+            // power of two sized tables are rendered through the inverse FFT
 
-                maxValue = fmax( abs( tmp ), maxValue );
+            FFT fft( tableSize );
+            std::vector<float> real( tableSize );
+            std::vector<float> imag( tableSize );
+
+            renderPartials( fft, waveformType, partials, real.data(), imag.data(), full.data() );
+            if ( needsLower ) {
+                renderPartials( fft, waveformType, partials - 1, real.data(), imag.data(), lower.data() );
             }
+        } else {
+            // other sizes are summed directly
 
-            if ( waveformType == WaveForms::SQUARE ) {
-                // square waves are very violent, when smoothing is specified
-                // apply gentle fades around the start/end of the waveform
-                int smoothRange = 4;
-                float factor = 1.0 / smoothRange;
-                if ( TABLE_SIZE >= ( smoothRange * 2 )) {
-                    int fadeOutPos = TABLE_SIZE - smoothRange;
-                    int tableEnd   = TABLE_SIZE - 1;
-                    for ( int j = 0; j < TABLE_SIZE; ++j ) {
-                        // gentle fade in
-                        if ( j < smoothRange ) {
-                            outputBuffer[ j ] *= ( j == 0 ? 0 : j * factor );
-                        }
-                        // gentle fade out
-                        if ( j >= fadeOutPos ) {
-                            outputBuffer[ j ] *= (( tableEnd - j ) * factor );
-                        }
-                    }
-                }
-            } else {
-                // normalize values for all other waveforms to keep them in the -1 to +1 range
-                float factor = 1.0 / maxValue;
-                for ( int j = 0; j < TABLE_SIZE; ++j ) {
-                    outputBuffer[ j ] *= factor;
-                }
+            std::vector<float> sines( tableSize );
+            for ( int t = 0; t < tableSize; ++t ) {
+                sines[ t ] = ( float ) WaveformMath::sine( WaveformMath::TWO_PI * t / tableSize );
+            }
+            WaveformMath::sumPartials( waveformType, partials, tableSize, sines.data(), full.data() );
+            if ( needsLower ) {
+                WaveformMath::sumPartials( waveformType, partials - 1, tableSize, sines.data(), lower.data() );
             }
         }
+        WaveformMath::shape( waveformType, partials, tableSize, full.data(), lower.data(), outputBuffer );
+
         return waveTable;
     }
 }
@@ -38,13 +38,15 @@ namespace WaveGenerator
         SQUARE
     };
 
-    // generate a WaveTable for given waveformType
+    const int AMOUNT_OF_WAVEFORMS = WaveForms::SQUARE + 1;
+
+    // generate a WaveTable for given waveformType, band limited for given sample rate
     // NOTE : wave table generation has high CPU demands
     // instead of doing this during live audio synthesis, it is
     // better to precache the WaveTables upon application start
     // (also see TablePool for maintaining the cache)
 
-    extern WaveTable* generate( WaveForms waveformType );
+    extern WaveTable* generate( WaveForms waveformType, float sampleRate, int tableSize );
 }
 } // E.O namespace Igorski
 
@@ -26,14 +26,10 @@ namespace Igorski {
 
 /* constructor / destructor */
 
-WaveTable::WaveTable( int aTableLength, float aFrequency )
+WaveTable::WaveTable( int aTableLength )
 {
-    tableLength  = aTableLength;
-    _accumulator = 0.0;
-    _buffer      = generateSilentBuffer( tableLength );
-    setFrequency( aFrequency );
-
-    _sampleRateOverLength = ( float ) VST::SAMPLE_RATE / ( float ) tableLength;
+    tableLength = aTableLength;
+    _buffer     = generateSilentBuffer( tableLength );
 }
 
 WaveTable::~WaveTable()
@@ -43,16 +39,6 @@ WaveTable::~WaveTable()
 
 /* public methods */
 
-void WaveTable::setFrequency( float aFrequency )
-{
-    _frequency = aFrequency;
-}
-
-float WaveTable::getFrequency()
-{
-    return _frequency;
-}
-
 bool WaveTable::hasContent()
 {
     for ( int i = 0; i < tableLength; ++i )
@@ -63,16 +49,6 @@ bool WaveTable::hasContent()
     return false;
 }
 
-void WaveTable::setAccumulator( float value )
-{
-    _accumulator = value;
-}
-
-float WaveTable::getAccumulator()
-{
-    return _accumulator;
-}
-
 float* WaveTable::getBuffer()
 {
     return _buffer;
@@ -102,8 +78,7 @@ void WaveTable::cloneTable( WaveTable* waveTable )
 
 WaveTable* WaveTable::clone()
 {
-    WaveTable* out    = new WaveTable( tableLength, _frequency );
-    out->_accumulator = _accumulator;
+    WaveTable* out = new WaveTable( tableLength );
     out->cloneTable( this );
 
     return out;
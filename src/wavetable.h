@@ -26,55 +26,29 @@
 #include "global.h"
 
 namespace Igorski {
+
+/**
+ * A WaveTable holds a single cycle of a waveform. Once generated, its contents
+ * are treated as immutable so a single table can be shared by all Oscillators
+ * reading from it (see TablePool and Oscillator)
+ */
 class WaveTable
 {
     public:
-        WaveTable( int aTableLength, float aFrequency );
+        WaveTable( int aTableLength );
         ~WaveTable();
 
         int tableLength;
         float* getBuffer();
         void setBuffer( float* aBuffer );
 
-        void setFrequency( float aFrequency );
-        float getFrequency();
-
         bool hasContent();
 
-        // accumulators are used to retrieve a sample from the wave table
-
-        float getAccumulator();
-        void setAccumulator( float offset );
-
-        /**
-         * retrieve a value from the wave table for the current
-         * accumulator position, this method also increments
-         * the accumulator and keeps it within bounds
-         */
-        inline float peek()
-        {
-            // the wave table offset to read from
-            int readOffset = ( _accumulator == 0 ) ? 0 : ( int ) ( _accumulator / _sampleRateOverLength );
-
-            // increment the accumulators read offset
-            _accumulator += _frequency;
-
-            // keep the accumulator in the bounds of the sample frequency
-            if ( _accumulator > VST::SAMPLE_RATE )
-                _accumulator -= VST::SAMPLE_RATE;
-
-            // return the sample present at the calculated offset within the table
-            return _buffer[ readOffset ];
-        }
-
         void cloneTable( WaveTable* waveTable );
         WaveTable* clone();
 
     protected:
-        float* _buffer;       // cached buffer (is a wave table)
-        float _accumulator;   // is read offset in wave table buffer
-        float _frequency;     // frequency (in Hz) of waveform cycle when reading
-        float _sampleRateOverLength;
+        float* _buffer; // cached buffer (is a wave table)
 
         float* generateSilentBuffer( int bufferSize );
 };
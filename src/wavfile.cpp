@@ -0,0 +1,205 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "wavfile.h"
+#include "realtimecheck.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace Igorski {
+namespace WavFile
+{
+    static const int FORMAT_PCM        = 1;
+    static const int FORMAT_FLOAT      = 3;
+    static const int FORMAT_EXTENSIBLE = 0xFFFE;
+
+    // WAV data is little endian, assemble values byte wise to remain platform agnostic
+
+    static uint32 readUInt( const unsigned char* data, int bytes )
+    {
+        uint32 value = 0;
+        for ( int i = 0; i < bytes; ++i ) {
+            value |= ( uint32 ) data[ i ] << ( 8 * i );
+        }
+        return value;
+    }
+
+    static float readSample( const unsigned char* data, int bitsPerSample, bool isFloat )
+    {
+        if ( isFloat ) {
+            uint32 bits = readUInt( data, 4 );
+            float value;
+            memcpy( &value, &bits, sizeof( float ));
+            return value;
+        }
+        switch ( bitsPerSample ) {
+            case 8:
+                return (( float ) data[ 0 ] - 128.f ) / 128.f; // 8-bit WAV is unsigned
+            case 16:
+                return ( float )( int16 ) readUInt( data, 2 ) / 32768.f;
+            case 24:
+                return ( float )(( int32 )( readUInt( data, 3 ) << 8 ) >> 8 ) / 8388608.f;
+            default:
+            case 32:
+                return ( float )(( double )( int32 ) readUInt( data, 4 ) / 2147483648.0 );
+        }
+    }
+
+    static void writeUInt( unsigned char* data, uint32 value, int bytes )
+    {
+        for ( int i = 0; i < bytes; ++i ) {
+            data[ i ] = ( unsigned char ) ( value >> ( 8 * i ));
+        }
+    }
+
+    AudioBuffer* read( const char* path, float& sampleRate )
+    {
+        RT_ASSERT_NOT_REALTIME( "WavFile::read" );
+
+        FILE* file = fopen( path, "rb" );
+
+        if ( file == nullptr ) {
+            return nullptr;
+        }
+
+        unsigned char header[ 12 ];
+        if ( fread( header, 1, 12, file ) != 12 || memcmp( header, "RIFF", 4 ) != 0 || memcmp( header + 8, "WAVE", 4 ) != 0 ) {
+            fclose( file );
+            return nullptr;
+        }
+
+        int format = 0, amountOfChannels = 0, bitsPerSample = 0;
+        std::vector<unsigned char> data;
+
+        // walk the chunks, we only require the format and data chunks
+
+        unsigned char chunkHeader[ 8 ];
+        while ( fread( chunkHeader, 1, 8, file ) == 8 ) {
+            uint32 chunkSize = readUInt( chunkHeader + 4, 4 );
+
+            if ( memcmp( chunkHeader, "fmt ", 4 ) == 0 && chunkSize >= 16 ) {
+                std::vector<unsigned char> fmt( chunkSize );
+                if ( fread( fmt.data(), 1, chunkSize, file ) != chunkSize ) {
+                    break;
+                }
+                format           = readUInt( fmt.data(), 2 );
+                amountOfChannels = readUInt( fmt.data() + 2, 2 );
+                sampleRate       = ( float ) readUInt( fmt.data() + 4, 4 );
+                bitsPerSample    = readUInt( fmt.data() + 14, 2 );
+
+                // the extensible format stores the actual format as the first bytes of its sub format GUID
+                if ( format == FORMAT_EXTENSIBLE && chunkSize >= 26 ) {
+                    format = readUInt( fmt.data() + 24, 2 );
+                }
+            }
+            else if ( memcmp( chunkHeader, "data", 4 ) == 0 ) {
+                data.resize( chunkSize );
+                data.resize( fread( data.data(), 1, chunkSize, file ));
+                break;
+            }
+            else {
+                fseek( file, chunkSize, SEEK_CUR );
+            }
+            // chunks are word aligned
+            if ( chunkSize % 2 == 1 ) {
+                fseek( file, 1, SEEK_CUR );
+            }
+        }
+        fclose( file );
+
+        bool isFloat = format == FORMAT_FLOAT && bitsPerSample == 32;
+        bool isPCM   = format == FORMAT_PCM && ( bitsPerSample == 8 || bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32 );
+
+        if (( !isFloat && !isPCM ) || amountOfChannels <= 0 || data.empty()) {
+            return nullptr;
+        }
+
+        int bytesPerSample = bitsPerSample / 8;
+        int frameSize      = bytesPerSample * amountOfChannels;
+        int amountOfFrames = ( int )( data.size() / frameSize );
+
+        if ( amountOfFrames == 0 ) {
+            return nullptr;
+        }
+
+        AudioBuffer* output = new AudioBuffer( amountOfChannels, amountOfFrames );
+
+        for ( int c = 0; c < amountOfChannels; ++c ) {
+            float* channelBuffer = output->getBufferForChannel( c );
+            const unsigned char* frame = data.data() + c * bytesPerSample;
+
+            for ( int i = 0; i < amountOfFrames; ++i, frame += frameSize ) {
+                channelBuffer[ i ] = readSample( frame, bitsPerSample, isFloat );
+            }
+        }
+        return output;
+    }
+
+    bool write( const char* path, AudioBuffer* buffer, float sampleRate )
+    {
+        RT_ASSERT_NOT_REALTIME( "WavFile::write" );
+
+        int amountOfChannels = buffer->amountOfChannels;
+        int frameSize        = amountOfChannels * sizeof( float );
+        uint32 dataSize      = ( uint32 ) buffer->bufferSize * frameSize;
+
+        // RIFF header followed by the format chunk (of the 16 byte variant) and the data chunk header
+
+        unsigned char header[ 44 ];
+
+        memcpy( header, "RIFF", 4 );
+        writeUInt( header + 4, 36 + dataSize, 4 );
+        memcpy( header + 8, "WAVEfmt ", 8 );
+        writeUInt( header + 16, 16, 4 );
+        writeUInt( header + 20, FORMAT_FLOAT, 2 );
+        writeUInt( header + 22, amountOfChannels, 2 );
+        writeUInt( header + 24, ( uint32 ) sampleRate, 4 );
+        writeUInt( header + 28, ( uint32 ) sampleRate * frameSize, 4 );
+        writeUInt( header + 32, frameSize, 2 );
+        writeUInt( header + 34, 32, 2 );
+        memcpy( header + 36, "data", 4 );
+        writeUInt( header + 40, dataSize, 4 );
+
+        std::vector<unsigned char> data( dataSize );
+        unsigned char* frame = data.data();
+
+        for ( int i = 0; i < buffer->bufferSize; ++i ) {
+            for ( int c = 0; c < amountOfChannels; ++c, frame += 4 ) {
+                uint32 bits;
+                memcpy( &bits, buffer->getBufferForChannel( c ) + i, sizeof( float ));
+                writeUInt( frame, bits, 4 );
+            }
+        }
+
+        FILE* file = fopen( path, "wb" );
+
+        if ( file == nullptr ) {
+            return false;
+        }
+        bool written = fwrite( header, 1, 44, file ) == 44 && fwrite( data.data(), 1, dataSize, file ) == dataSize;
+        fclose( file );
+
+        return written;
+    }
+}
+} // E.O namespace Igorski
@@ -0,0 +1,47 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __WAVFILE_H_INCLUDED__
+#define __WAVFILE_H_INCLUDED__
+
+#include "audiobuffer.h"
+
+namespace Igorski {
+namespace WavFile
+{
+    // reads the WAV file at given path into a newly allocated AudioBuffer
+    // (with one channel per channel in the file), the files sample rate is
+    // written into sampleRate. Supports integer PCM (8, 16, 24 and 32-bit)
+    // and 32-bit floating point data. Returns nullptr when the file could not be read
+    // NOTE : this reads from disk and allocates, never invoke this on the audio thread
+
+    extern AudioBuffer* read( const char* path, float& sampleRate );
+
+    // writes the contents of given AudioBuffer (interleaving its channels) into a 32-bit floating
+    // point WAV file at given path. Returns false when the file could not be written
+    // NOTE : this writes to disk, never invoke this on the audio thread
+
+    extern bool write( const char* path, AudioBuffer* buffer, float sampleRate );
+}
+} // E.O namespace Igorski
+
+#endif
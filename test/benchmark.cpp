@@ -0,0 +1,150 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "../src/plugin_process.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+using namespace Igorski;
+
+/**
+ * Measures the time and memory it takes to create a PluginProcess, the cost a host pays for each
+ * instance of the plugin when loading a project. As the PluginProcess is created once the processing
+ * setup is known (see Darvaza::createPluginProcess()) this is compared against creating it at the
+ * default context first and applying the negotiated context afterwards.
+ *
+ * usage : instance_benchmark [amount of instances per measurement, defaults to 20]
+ */
+
+// normally defined by the plugin (see vst.cpp), which is not part of the benchmark
+
+float VST::SAMPLE_RATE = 44100.f;
+
+// the resident memory of the process in KB (measuring the allocations as well as the mapped
+// memory, e.g. of the mirrored RingBuffer), only available on Linux
+
+static long getResidentKilobytes()
+{
+#ifdef __linux__
+    long size = 0, residentPages = 0;
+    FILE* file = fopen( "/proc/self/statm", "r" );
+
+    if ( file == nullptr ) {
+        return -1;
+    }
+    if ( fscanf( file, "%ld %ld", &size, &residentPages ) != 2 ) {
+        residentPages = -1;
+    }
+    fclose( file );
+
+    return residentPages < 0 ? -1 : residentPages * ( sysconf( _SC_PAGESIZE ) / 1024 );
+#else
+    return -1;
+#endif
+}
+
+typedef std::chrono::steady_clock Clock;
+
+struct Measurement {
+    double milliseconds = 0.0;  // per instance
+    double kilobytes    = -1.0; // resident memory per instance (-1 when not available)
+};
+
+// creates given amount of instances at the given context, when deferred is false each instance is first
+// created at the default context after which the given context is applied (as hosts negotiate the
+// processing setup after instantiation)
+
+static Measurement measure( const ProcessingContext& context, int amountOfInstances, bool deferred )
+{
+    std::vector<PluginProcess*> instances;
+    instances.reserve( amountOfInstances );
+
+    Measurement result;
+
+    long residentBefore = getResidentKilobytes();
+    Clock::time_point start = Clock::now();
+
+    for ( int i = 0; i < amountOfInstances; ++i ) {
+        if ( deferred ) {
+            instances.push_back( new PluginProcess( 2, context ));
+        } else {
+            PluginProcess* instance = new PluginProcess( 2, ProcessingContext());
+            instance->setProcessingContext( context );
+            instances.push_back( instance );
+        }
+    }
+    double elapsed = std::chrono::duration<double, std::milli>( Clock::now() - start ).count();
+
+    result.milliseconds = elapsed / amountOfInstances;
+    long residentAfter  = getResidentKilobytes();
+
+    if ( residentBefore >= 0 && residentAfter >= 0 ) {
+        result.kilobytes = ( double ) ( residentAfter - residentBefore ) / amountOfInstances;
+    }
+
+    for ( PluginProcess* instance : instances ) {
+        delete instance;
+    }
+    return result;
+}
+
+int main( int argc, char** argv )
+{
+    int amountOfInstances = argc > 1 ? std::max( 1, atoi( argv[ 1 ])) : 20;
+
+    const ProcessingContext contexts[] = {
+        { 44100.f,  512 },
+        { 48000.f,  1024 },
+        { 96000.f,  2048 },
+        { 192000.f, 4096 },
+    };
+
+    printf( "%d instances per measurement\n\n", amountOfInstances );
+    printf( "%-18s %-20s %-20s %s\n", "context", "created at context", "context applied", "resident memory per instance" );
+
+    for ( const ProcessingContext& context : contexts ) {
+        measure( context, 1, true ); // warm up (e.g. the shared wave tables)
+
+        Measurement deferred  = measure( context, amountOfInstances, true );
+        Measurement reapplied = measure( context, amountOfInstances, false );
+
+        char name[ 32 ], deferredTime[ 32 ], reappliedTime[ 32 ];
+        snprintf( name,          sizeof( name ),          "%.0f Hz / %d", context.sampleRate, context.maxBlockSize );
+        snprintf( deferredTime,  sizeof( deferredTime ),  "%.3f ms", deferred.milliseconds );
+        snprintf( reappliedTime, sizeof( reappliedTime ), "%.3f ms", reapplied.milliseconds );
+
+        printf( "%-18s %-20s %-20s ", name, deferredTime, reappliedTime );
+        if ( deferred.kilobytes >= 0.0 ) {
+            printf( "%.0f KB (vs %.0f KB)\n", deferred.kilobytes, reapplied.kilobytes );
+        } else {
+            printf( "n/a\n" );
+        }
+    }
+    return 0;
+}
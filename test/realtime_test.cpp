@@ -0,0 +1,159 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "testdriver.h"
+#include "../src/realtimecheck.h"
+#include <cstdio>
+#include <string>
+
+#if defined( __linux__ ) || defined( __APPLE__ )
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define CAN_VERIFY_ABORT
+#endif
+
+using namespace Igorski;
+
+/**
+ * Verifies the real-time safety of the processing. Built with DARVAZA_RT_CHECK defined, any
+ * allocation, lock or blocking call made while rendering (which takes place within a realtime scope,
+ * see TestDriver::render()) aborts the test with a stack trace.
+ *
+ * The TestDriver scenarios and a script cycling through all parameter and transport changes are
+ * rendered at a range of block sizes (including a single sample and blocks exceeding the maximum
+ * block size of the processing context), with separate and aliased (in place) buffers and in 64-bit.
+ * Unlike the render test, the quality governor remains enabled so the tier changes are exercised.
+ *
+ * Where supported, the test first verifies that an allocation within a realtime scope does abort.
+ *
+ * usage : realtime_test <reference directory> (providing the impulse response for the convolution scenario)
+ */
+
+static const int MAX_BLOCK_SIZE = 1024;
+static const int BLOCK_SIZES[]  = { 1, 7, 64, 77, 256, 512, 1000, 1024, 3000 };
+
+// a script applying every type of event in turn, every 997 samples (so the events
+// fall on different positions within the blocks for all block sizes)
+
+static TestDriver::Scenario createCyclingScenario()
+{
+    TestDriver::Scenario scenario = { "all_events", MAX_BLOCK_SIZE, false, {} };
+
+    int amountOfTypes = TestDriver::EventTypes::TEMPO + 1;
+    int index = 0;
+
+    for ( int position = 0; position < TestDriver::STIMULUS_LENGTH; position += 997, ++index ) {
+        TestDriver::EventTypes type = ( TestDriver::EventTypes ) ( index % amountOfTypes );
+        float value = ( float ) (( index * 7 ) % 11 ) / 10.f;
+
+        if ( type == TestDriver::EventTypes::TEMPO ) {
+            value = 60.f + value * 120.f;
+        }
+        scenario.script.push_back({ position, type, value });
+    }
+    return scenario;
+}
+
+// allocates within a realtime scope in a child process, which is expected to abort
+
+static bool verifyCheckAborts()
+{
+#ifdef CAN_VERIFY_ABORT
+    pid_t child = fork();
+
+    if ( child == 0 ) {
+        freopen( "/dev/null", "w", stderr ); // omit the reported violation
+        {
+            RT_SCOPE( "realtime_test" );
+            static char* volatile allocated; // volatile so the allocation is not optimized away
+            allocated = new char[ 64 ];
+            ( void ) allocated;
+        }
+        _exit( 0 );
+    }
+    int status = 0;
+    waitpid( child, &status, 0 );
+
+    return WIFSIGNALED( status ) && WTERMSIG( status ) == SIGABRT;
+#else
+    return true;
+#endif
+}
+
+int main( int argc, char** argv )
+{
+    if ( argc < 2 ) {
+        printf( "usage : %s <reference directory>\n", argv[ 0 ]);
+        return 1;
+    }
+
+    if ( !verifyCheckAborts() ) {
+        printf( "FAILED   allocating within a realtime scope did not abort, is DARVAZA_RT_CHECK defined?\n" );
+        return 1;
+    }
+    std::string impulseResponsePath = std::string( argv[ 1 ] ) + "/impulse_response.wav";
+
+    AudioBuffer* stimulus  = TestDriver::createStimulus();
+    AudioBuffer* sideChain = TestDriver::createSideChainStimulus();
+    AudioBuffer* output    = new AudioBuffer( stimulus->amountOfChannels, stimulus->bufferSize );
+
+    std::vector<TestDriver::Scenario> scenarios = TestDriver::getScenarios();
+    scenarios.push_back( createCyclingScenario() );
+
+    long renderedSamples = 0;
+
+    for ( auto& scenario : scenarios ) {
+        for ( int blockSize : BLOCK_SIZES ) {
+            for ( int variant = 0; variant < 3; ++variant ) {
+                PluginProcess* process = TestDriver::createProcess(
+                    MAX_BLOCK_SIZE, scenario.convolution ? impulseResponsePath.c_str() : nullptr
+                );
+                process->deadlineMonitor->enableGovernor( true );
+
+                if ( scenario.convolution && !process->hasImpulseResponse() ) {
+                    printf( "could not read impulse response from %s\n", impulseResponsePath.c_str() );
+                    return 1;
+                }
+
+                TestDriver::RenderOptions options;
+
+                options.blockSize       = blockSize;
+                options.inPlace         = variant > 0;
+                options.doublePrecision = variant == 2;
+
+                TestDriver::render( process, stimulus, sideChain, output, scenario.script, options );
+                renderedSamples += stimulus->bufferSize;
+
+                delete process;
+            }
+        }
+        printf( "ok       %-18s rendered at all block sizes without real-time violations\n", scenario.name );
+    }
+    printf( "rendered %ld samples\n", renderedSamples );
+
+    delete output;
+    delete stimulus;
+    delete sideChain;
+
+    return 0;
+}
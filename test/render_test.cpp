@@ -0,0 +1,216 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "testdriver.h"
+#include "../src/arena.h"
+#include "../src/vectorops.h"
+#include "../src/wavfile.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using namespace Igorski;
+
+/**
+ * Renders the TestDriver scenarios and compares them against the references checked in
+ * under test/references. Each scenario is rendered once more with the scalar kernels forced
+ * (see VectorOps::forceScalar), with the input and output buffers aliased and in 64-bit
+ * (with and without aliasing), and these variants are compared against the SIMD render.
+ * Beforehand, the sizing of the Arena of the PluginProcess is verified.
+ *
+ * usage : render_test <reference directory>
+ *         render_test --write <reference directory> (renders the references, after a deliberate change in output)
+ */
+
+// tolerances for the comparisons, beyond which the test fails
+
+static const float REFERENCE_TOLERANCE_DB = -90.f; // allows for differences in libm/compiler across platforms
+static const float VARIANT_TOLERANCE_DB   = -90.f; // scalar kernels, 64-bit processing
+
+static const char* IMPULSE_RESPONSE_FILE = "impulse_response.wav";
+
+static AudioBuffer* renderScenario( const TestDriver::Scenario& scenario, AudioBuffer* stimulus, AudioBuffer* sideChain,
+                                    const std::string& impulseResponsePath, bool inPlace, bool doublePrecision )
+{
+    PluginProcess* process = TestDriver::createProcess( scenario.blockSize, scenario.convolution ? impulseResponsePath.c_str() : nullptr );
+
+    if ( scenario.convolution && !process->hasImpulseResponse() ) {
+        printf( "could not read impulse response from %s\n", impulseResponsePath.c_str() );
+        delete process;
+        return nullptr;
+    }
+
+    TestDriver::RenderOptions options;
+
+    options.blockSize       = scenario.blockSize;
+    options.inPlace         = inPlace;
+    options.doublePrecision = doublePrecision;
+
+    AudioBuffer* output = new AudioBuffer( stimulus->amountOfChannels, stimulus->bufferSize );
+
+    TestDriver::render( process, stimulus, sideChain, output, scenario.script, options );
+
+    delete process;
+
+    return output;
+}
+
+// verifies the Arena of the PluginProcess is sized exactly for its child processors, for a range
+// of channel amounts and sample rates (the PluginProcess aborts itself on a sizing error, this
+// reports the sizes)
+
+static bool verifyArenaSizing()
+{
+    const int   channelAmounts[] = { 1, 2, 3, 6, PluginProcess::MAX_CHANNELS };
+    const float sampleRates[]    = { 22050.f, 44100.f, 96000.f, 192000.f, 384000.f };
+
+    bool passed = true;
+
+    for ( int amountOfChannels : channelAmounts ) {
+        for ( float sampleRate : sampleRates ) {
+            ProcessingContext context;
+            context.sampleRate = sampleRate;
+
+            PluginProcess* process = new PluginProcess( amountOfChannels, context );
+            Arena* arena = process->getArena();
+
+            if ( arena->getUsed() != arena->getCapacity() ) {
+                printf( "FAILED   arena for %d channels at %.0f Hz uses %zu of %zu bytes\n",
+                    amountOfChannels, sampleRate, arena->getUsed(), arena->getCapacity()
+                );
+                passed = false;
+            }
+            delete process;
+        }
+        if ( passed ) {
+            printf( "ok       arena for %d channels sized exactly at all sample rates\n", amountOfChannels );
+        }
+    }
+    return passed;
+}
+
+static bool report( const char* scenario, const char* variant, AudioBuffer* reference, AudioBuffer* output, float tolerance, bool mustBeExact )
+{
+    if ( output == nullptr ) {
+        printf( "FAILED   %-18s %-15s could not be rendered\n", scenario, variant );
+        return false;
+    }
+    TestDriver::Residual residual = TestDriver::compare( reference, output );
+    bool passed = residual.bitExact || ( !mustBeExact && residual.residualDb <= tolerance );
+
+    printf( "%-8s %-18s %-15s %s (residual %.1f dB, peak %.1f dBFS)\n",
+        passed ? "ok" : "FAILED", scenario, variant, residual.bitExact ? "bit-exact" : "null test",
+        residual.residualDb, residual.peakResidualDb
+    );
+    return passed;
+}
+
+int main( int argc, char** argv )
+{
+    bool write = argc > 2 && strcmp( argv[ 1 ], "--write" ) == 0;
+
+    if ( argc < 2 || ( argc > 2 && !write )) {
+        printf( "usage : %s [--write] <reference directory>\n", argv[ 0 ]);
+        return 1;
+    }
+    std::string directory = argv[ write ? 2 : 1 ];
+
+    std::string impulseResponsePath = directory + "/" + IMPULSE_RESPONSE_FILE;
+
+    if ( write ) {
+        AudioBuffer* impulseResponse = TestDriver::createImpulseResponse();
+        bool written = WavFile::write( impulseResponsePath.c_str(), impulseResponse, TestDriver::SAMPLE_RATE );
+        delete impulseResponse;
+
+        if ( !written ) {
+            printf( "could not write %s\n", impulseResponsePath.c_str() );
+            return 1;
+        }
+    }
+
+    AudioBuffer* stimulus  = TestDriver::createStimulus();
+    AudioBuffer* sideChain = TestDriver::createSideChainStimulus();
+
+    bool passed = write ? true : verifyArenaSizing();
+
+    for ( auto& scenario : TestDriver::getScenarios() ) {
+        std::string path = directory + "/" + scenario.name + ".wav";
+
+        AudioBuffer* output = renderScenario( scenario, stimulus, sideChain, impulseResponsePath, false, false );
+
+        if ( output == nullptr ) {
+            passed = false;
+            continue;
+        }
+
+        if ( write ) {
+            if ( !WavFile::write( path.c_str(), output, TestDriver::SAMPLE_RATE )) {
+                printf( "could not write %s\n", path.c_str() );
+                passed = false;
+            }
+            delete output;
+            continue;
+        }
+
+        // against the reference
+
+        float sampleRate;
+        AudioBuffer* reference = WavFile::read( path.c_str(), sampleRate );
+
+        if ( reference == nullptr || reference->amountOfChannels != output->amountOfChannels ||
+             reference->bufferSize != output->bufferSize ) {
+            printf( "FAILED   %-18s could not read a matching reference from %s\n", scenario.name, path.c_str() );
+            passed = false;
+        } else {
+            passed &= report( scenario.name, "reference", reference, output, REFERENCE_TOLERANCE_DB, false );
+        }
+        delete reference;
+
+        // the processing variants against the render above, aliasing the buffers must not change the
+        // output (in either precision) while the scalar kernels and 64-bit processing may round differently
+
+        VectorOps::forceScalar = true;
+        AudioBuffer* variant = renderScenario( scenario, stimulus, sideChain, impulseResponsePath, false, false );
+        VectorOps::forceScalar = false;
+
+        passed &= report( scenario.name, "scalar", output, variant, VARIANT_TOLERANCE_DB, false );
+        delete variant;
+
+        variant = renderScenario( scenario, stimulus, sideChain, impulseResponsePath, true, false );
+        passed &= report( scenario.name, "in place", output, variant, 0.f, true );
+        delete variant;
+
+        AudioBuffer* output64 = renderScenario( scenario, stimulus, sideChain, impulseResponsePath, false, true );
+        passed &= report( scenario.name, "64-bit", output, output64, VARIANT_TOLERANCE_DB, false );
+
+        variant = renderScenario( scenario, stimulus, sideChain, impulseResponsePath, true, true );
+        passed &= report( scenario.name, "64-bit in place", output64, variant, 0.f, true );
+        delete variant;
+
+        delete output64;
+        delete output;
+    }
+    delete stimulus;
+    delete sideChain;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,416 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "testdriver.h"
+#include "../src/realtimecheck.h"
+#include <algorithm>
+#include <math.h>
+
+namespace Igorski {
+
+// normally defined by the plugin (see vst.cpp), which is not part of the test executables
+
+float VST::SAMPLE_RATE = TestDriver::SAMPLE_RATE;
+
+namespace TestDriver {
+
+    std::vector<Scenario> getScenarios()
+    {
+        return {
+            // tempo synchronized gates, bit crushing and slowed down playback from the record buffer
+            // while the sequencer stops and restarts and the tempo changes. Halfway the playback
+            // returns to the incoming input and the reverb is bypassed for a while (so the chain
+            // can be processed in place and the wet signal isn't masked by a frozen reverb)
+            {
+                "lfo_gate", 512, false, {
+                    { 0,     PLAY,           0.f   },
+                    { 0,     GATE_WAVEFORM,  .3f   },
+                    { 0,     ODD_GATE_SPEED, .5f   },
+                    { 0,     EVEN_GATE_SPEED,.7f   },
+                    { 0,     BIT_DEPTH,      .4f   },
+                    { 0,     RESAMPLE_RATE,  .3f   },
+                    { 0,     PLAYBACK_RATE,  .4f   },
+                    { 0,     REVERB,         1.f   },
+                    { 0,     DRY_MIX,        .5f   },
+                    { 12000, BIT_DEPTH,      .7f   },
+                    { 16384, ODD_GATE_SPEED, .25f  },
+                    { 20000, TEMPO,          96.f  },
+                    { 28000, LINK_GATES,     1.f   },
+                    { 30000, RESAMPLE_RATE,  0.f   },
+                    { 30000, PLAYBACK_RATE,  0.f   },
+                    { 30000, REVERB,         0.f   },
+                    { 32768, STOP,           0.f   },
+                    { 36001, PLAY,           0.f   },
+                    { 44100, GATE_WAVEFORM,  .8f   },
+                    { 48000, RESAMPLE_RATE,  .5f   },
+                    { 48000, REVERB,         1.f   },
+                    { 50000, LIMITER_MODE,   0.f   },
+                    { 56000, TEMPO,          140.f },
+                }
+            },
+            // the high quality mode (Hermite interpolation, oversampled bit crushing and the dense
+            // reverb) using the FDN reverb engine, while harmonizing, reversing and randomizing the gates
+            {
+                "high_quality_fdn", 77, false, {
+                    { 0,     PLAY,           0.f   },
+                    { 0,     QUALITY_MODE,   1.f   },
+                    { 0,     REVERB_ENGINE,  1.f   },
+                    { 0,     REVERB,         1.f   },
+                    { 0,     HARMONY,        .5f   },
+                    { 0,     BIT_DEPTH,      .5f   },
+                    { 0,     RESAMPLE_RATE,  .6f   },
+                    { 0,     PLAYBACK_RATE,  .7f   },
+                    { 0,     DRY_MIX,        .3f   },
+                    { 20000, REVERSE,        1.f   },
+                    { 30000, RANDOM_SPEED,   .6f   },
+                    { 40000, REVERB_ENGINE,  0.f   },
+                    { 48000, REVERSE,        0.f   },
+                    { 52000, QUALITY_MODE,   .5f   },
+                }
+            },
+            // gates following the envelope of the side chain input, switching detectors
+            {
+                "sidechain_gate", 1024, false, {
+                    { 0,     PLAY,                0.f },
+                    { 0,     GATE_MODE,           1.f },
+                    { 0,     SIDECHAIN_ATTACK,    .2f },
+                    { 0,     SIDECHAIN_RELEASE,   .5f },
+                    { 0,     SIDECHAIN_THRESHOLD, .3f },
+                    { 0,     DRY_MIX,             .2f },
+                    { 0,     LIMITER_MODE,        .5f },
+                    { 24000, SIDECHAIN_THRESHOLD, .6f },
+                    { 32768, GATE_MODE,           .5f },
+                    { 40000, REVERB,              1.f },
+                    { 48000, GATE_MODE,           0.f },
+                }
+            },
+            // the partitioned convolution reverb (including its frozen tail on each beat) on
+            // downsampled input, at a block size that does not align with its partitions
+            {
+                "convolution", 300, true, {
+                    { 0,     PLAY,           0.f   },
+                    { 0,     REVERB,         1.f   },
+                    { 0,     RESAMPLE_RATE,  .2f   },
+                    { 0,     BIT_DEPTH,      .3f   },
+                    { 0,     DRY_MIX,        .5f   },
+                    { 0,     GATE_WAVEFORM,  .6f   },
+                    { 16000, TEMPO,          150.f },
+                    { 30000, REVERB,         0.f   },
+                    { 34000, REVERB,         1.f   },
+                    { 45000, BIT_DEPTH,      .8f   },
+                }
+            }
+        };
+    }
+
+    AudioBuffer* createStimulus()
+    {
+        AudioBuffer* stimulus = new AudioBuffer( AMOUNT_OF_CHANNELS, STIMULUS_LENGTH );
+
+        float* left  = stimulus->getBufferForChannel( 0 );
+        float* right = stimulus->getBufferForChannel( 1 );
+
+        const int burstInterval = 11025; // noise bursts of 50 ms every 250 ms
+        const int burstLength   = 2205;
+        const int impulseInterval = 22050;
+
+        double phase = 0.0;
+        uint32 seed  = 12345;
+
+        for ( int i = 0; i < STIMULUS_LENGTH; ++i ) {
+            // exponential sine sweep from 40 Hz to 8 kHz, its quadrature on the right channel
+
+            double frequency = 40.0 * pow( 200.0, ( double ) i / STIMULUS_LENGTH );
+            phase += 2.0 * M_PI * frequency / SAMPLE_RATE;
+
+            left[ i ]  = ( float ) ( 0.4 * sin( phase ));
+            right[ i ] = ( float ) ( 0.3 * cos( phase ));
+
+            if (( i % burstInterval ) < burstLength ) {
+                seed = seed * 1664525 + 1013904223; // linear congruential generator (platform independent, unlike rand())
+                float noise = (( float ) ( seed >> 8 ) / 16777216.f - .5f ) * .5f;
+                left[ i ]  += noise;
+                right[ i ] -= noise * .5f;
+            }
+            if (( i % impulseInterval ) == 0 ) {
+                left[ i ]  = .9f;
+                right[ i ] = -.9f;
+            }
+        }
+        return stimulus;
+    }
+
+    AudioBuffer* createSideChainStimulus()
+    {
+        AudioBuffer* stimulus = new AudioBuffer( 1, STIMULUS_LENGTH );
+        float* buffer = stimulus->getBufferForChannel( 0 );
+
+        // a 110 Hz tone alternating between a loud and a quiet level every 100 ms
+
+        for ( int i = 0; i < STIMULUS_LENGTH; ++i ) {
+            float level = (( i / 4410 ) % 2 ) == 0 ? .5f : .02f;
+            buffer[ i ] = level * ( float ) sin( 2.0 * M_PI * 110.0 * i / SAMPLE_RATE );
+        }
+        return stimulus;
+    }
+
+    AudioBuffer* createImpulseResponse()
+    {
+        int length = ( int ) ( SAMPLE_RATE * .5f );
+
+        AudioBuffer* impulseResponse = new AudioBuffer( AMOUNT_OF_CHANNELS, length );
+        uint32 seed = 54321;
+
+        for ( int c = 0; c < AMOUNT_OF_CHANNELS; ++c ) {
+            float* buffer = impulseResponse->getBufferForChannel( c );
+
+            for ( int i = 0; i < length; ++i ) {
+                seed = seed * 1664525 + 1013904223;
+                float noise = ( float ) ( seed >> 8 ) / 16777216.f - .5f;
+                buffer[ i ] = noise * ( float ) exp( -6.9 * i / length ); // -60 dB at the end
+            }
+        }
+        return impulseResponse;
+    }
+
+    PluginProcess* createProcess( int maxBlockSize, const char* impulseResponsePath )
+    {
+        ProcessingContext context;
+
+        context.sampleRate   = SAMPLE_RATE;
+        context.maxBlockSize = maxBlockSize;
+
+        PluginProcess* process = new PluginProcess( AMOUNT_OF_CHANNELS, context );
+        process->deadlineMonitor->enableGovernor( false );
+
+        if ( impulseResponsePath != nullptr && process->loadImpulseResponse( impulseResponsePath )) {
+            process->setReverbEngine( PluginProcess::ReverbEngines::CONVOLUTION );
+        }
+        return process;
+    }
+
+    void apply( PluginProcess* process, const Event& event, HostState& state )
+    {
+        float value = event.value;
+
+        switch ( event.type ) {
+            case GATE_WAVEFORM:
+                process->createGateTables( value );
+                break;
+            case ODD_GATE_SPEED:
+                state.oddSpeed = value;
+                process->setGateSpeed( state.oddSpeed, state.evenSpeed, state.linkGates );
+                break;
+            case EVEN_GATE_SPEED:
+                state.evenSpeed = value;
+                process->setGateSpeed( state.oddSpeed, state.evenSpeed, state.linkGates );
+                break;
+            case LINK_GATES:
+                state.linkGates = value >= .5f;
+                process->setGateSpeed( state.oddSpeed, state.evenSpeed, state.linkGates );
+                break;
+            case RANDOM_SPEED:
+                process->randomizeGateSpeed( value );
+                break;
+            case BIT_DEPTH:
+                process->bitCrusher->setAmount( value );
+                break;
+            case RESAMPLE_RATE:
+                process->setResampleRate( value );
+                break;
+            case PLAYBACK_RATE:
+                process->setPlaybackRate( value );
+                break;
+            case HARMONY:
+                process->setHarmony( value );
+                break;
+            case REVERSE:
+                process->enableReverse( value >= .5f );
+                break;
+            case REVERB:
+                process->enableReverb( value >= .5f );
+                break;
+            case REVERB_ENGINE:
+                process->setReverbEngine( PluginProcess::toReverbEngine( value ));
+                break;
+            case DRY_MIX:
+                process->setDryMix( value );
+                break;
+            case GATE_MODE:
+                process->setGateMode( value );
+                break;
+            case SIDECHAIN_ATTACK:
+                process->setSideChainAttack( value );
+                break;
+            case SIDECHAIN_RELEASE:
+                process->setSideChainRelease( value );
+                break;
+            case SIDECHAIN_THRESHOLD:
+                process->setSideChainThreshold( value );
+                break;
+            case LIMITER_MODE:
+                process->setLimiterMode( value );
+                break;
+            case QUALITY_MODE:
+                process->setQualitySelection( value );
+                break;
+
+            // transport, as handled by Darvaza::process() when the host process context changes
+
+            case PLAY:
+                if ( !state.playing ) {
+                    process->resetReadWritePointers();
+                    process->resetGates();
+                    process->clearRecordBuffer();
+                }
+                state.playing = true;
+                break;
+            case STOP:
+                if ( state.playing ) {
+                    process->clearRecordBuffer();
+                }
+                state.playing = false;
+                break;
+            case TEMPO:
+                state.tempo = value;
+                if ( process->setTempo( state.tempo, 4, 4 )) {
+                    process->setGateSpeed( state.oddSpeed, state.evenSpeed, state.linkGates );
+                }
+                break;
+        }
+    }
+
+    template <typename SampleType>
+    static void renderSamples( PluginProcess* process, AudioBuffer* input, AudioBuffer* sideChain, AudioBuffer* output,
+                               const std::vector<Event>& script, const RenderOptions& options )
+    {
+        int amountOfChannels = input->amountOfChannels;
+        int length           = input->bufferSize;
+
+        // the block buffers are allocated up front (outside of the realtime scope)
+
+        std::vector<SampleType> inputs( amountOfChannels * options.blockSize );
+        std::vector<SampleType> outputs( amountOfChannels * options.blockSize );
+        std::vector<SampleType> sideChains( options.blockSize );
+
+        std::vector<SampleType*> in( amountOfChannels );
+        std::vector<SampleType*> out( amountOfChannels );
+
+        for ( int c = 0; c < amountOfChannels; ++c ) {
+            in[ c ]  = inputs.data()  + c * options.blockSize;
+            out[ c ] = options.inPlace ? in[ c ] : outputs.data() + c * options.blockSize;
+        }
+        SampleType* sideChainBuffers[ 1 ] = { sideChains.data() };
+
+        HostState state;
+        size_t nextEvent = 0;
+
+        for ( int position = 0; position < length; ) {
+            RT_SCOPE( "TestDriver::render" );
+
+            while ( nextEvent < script.size() && script[ nextEvent ].position <= position ) {
+                apply( process, script[ nextEvent++ ], state );
+            }
+
+            // blocks are split at the position of the next event
+
+            int bufferSize = std::min( options.blockSize, length - position );
+
+            if ( nextEvent < script.size() ) {
+                bufferSize = std::min( bufferSize, script[ nextEvent ].position - position );
+            }
+
+            for ( int c = 0; c < amountOfChannels; ++c ) {
+                const float* channel = input->getBufferForChannel( c ) + position;
+                for ( int i = 0; i < bufferSize; ++i ) {
+                    in[ c ][ i ] = ( SampleType ) channel[ i ];
+                }
+            }
+            if ( sideChain != nullptr ) {
+                const float* channel = sideChain->getBufferForChannel( 0 ) + position;
+                for ( int i = 0; i < bufferSize; ++i ) {
+                    sideChains[ i ] = ( SampleType ) channel[ i ];
+                }
+            }
+
+            process->process<SampleType>(
+                in.data(), out.data(), amountOfChannels, amountOfChannels, bufferSize, bufferSize * sizeof( SampleType ),
+                sideChain != nullptr ? sideChainBuffers : nullptr, sideChain != nullptr ? 1 : 0
+            );
+
+            for ( int c = 0; c < amountOfChannels; ++c ) {
+                float* channel = output->getBufferForChannel( c ) + position;
+                for ( int i = 0; i < bufferSize; ++i ) {
+                    channel[ i ] = ( float ) out[ c ][ i ];
+                }
+            }
+            position += bufferSize;
+        }
+    }
+
+    void render( PluginProcess* process, AudioBuffer* input, AudioBuffer* sideChain, AudioBuffer* output,
+                 const std::vector<Event>& script, const RenderOptions& options )
+    {
+        if ( options.doublePrecision ) {
+            renderSamples<double>( process, input, sideChain, output, script, options );
+        } else {
+            renderSamples<float>( process, input, sideChain, output, script, options );
+        }
+    }
+
+    Residual compare( AudioBuffer* reference, AudioBuffer* output )
+    {
+        Residual result;
+
+        double residualSquares  = 0.0;
+        double referenceSquares = 0.0;
+        float  peakResidual     = 0.f;
+
+        for ( int c = 0; c < reference->amountOfChannels; ++c ) {
+            const float* expected = reference->getBufferForChannel( c );
+            const float* actual   = output->getBufferForChannel( c );
+
+            for ( int i = 0; i < reference->bufferSize; ++i ) {
+                float residual = actual[ i ] - expected[ i ];
+
+                if ( actual[ i ] != expected[ i ] ) {
+                    result.bitExact = false;
+                }
+                residualSquares  += ( double ) residual * residual;
+                referenceSquares += ( double ) expected[ i ] * expected[ i ];
+                peakResidual      = std::max( peakResidual, fabsf( residual ));
+            }
+        }
+
+        // any residual against a silent reference is reported at 0 dB
+
+        if ( residualSquares > 0.0 ) {
+            double relative   = referenceSquares > 0.0 ? residualSquares / referenceSquares : 1.0;
+            result.residualDb = std::max( result.residualDb, ( float ) ( 10.0 * log10( relative )));
+        }
+        if ( peakResidual > 0.f ) {
+            result.peakResidualDb = std::max( result.peakResidualDb, 20.f * log10f( peakResidual ));
+        }
+        return result;
+    }
+}
+}
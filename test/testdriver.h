@@ -0,0 +1,148 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __TESTDRIVER_H_INCLUDED__
+#define __TESTDRIVER_H_INCLUDED__
+
+#include "../src/audiobuffer.h"
+#include "../src/plugin_process.h"
+#include "../src/processingcontext.h"
+#include <vector>
+
+/**
+ * Renders fixed stimuli through a PluginProcess while following a script of parameter changes and
+ * transport events, the way a host drives the plugin. The stimuli are generated (rather than read
+ * from disk) and all processing is deterministic, so renders can be compared against references.
+ *
+ * Events are applied at their exact sample position, as the render splits the block that position
+ * falls within (like a host delivering sample accurate automation). Note the output does depend on
+ * the block size (e.g. playback from the record buffer realigns with the input of each block), which
+ * is why each scenario defines the block size it is rendered at. The quality governor is disabled
+ * as its tiers depend on timing (see DeadlineMonitor).
+ */
+namespace Igorski {
+namespace TestDriver {
+
+    static const int   AMOUNT_OF_CHANNELS = 2;
+    static const int   STIMULUS_LENGTH    = 65536; // in samples
+    static constexpr float SAMPLE_RATE    = 44100.f;
+
+    // the properties a script can change, applied through the same PluginProcess methods
+    // as the host parameters (see Darvaza::syncProcess()) and host transport (see Darvaza::process())
+
+    enum EventTypes {
+        GATE_WAVEFORM,
+        ODD_GATE_SPEED,
+        EVEN_GATE_SPEED,
+        LINK_GATES,
+        RANDOM_SPEED,
+        BIT_DEPTH,
+        RESAMPLE_RATE,
+        PLAYBACK_RATE,
+        HARMONY,
+        REVERSE,
+        REVERB,
+        REVERB_ENGINE,
+        DRY_MIX,
+        GATE_MODE,
+        SIDECHAIN_ATTACK,
+        SIDECHAIN_RELEASE,
+        SIDECHAIN_THRESHOLD,
+        LIMITER_MODE,
+        QUALITY_MODE,
+        PLAY,           // starts the sequencer (the value is ignored)
+        STOP,           // stops the sequencer (the value is ignored)
+        TEMPO           // value is in BPM
+    };
+
+    struct Event {
+        int        position; // in samples from the start of the render
+        EventTypes type;
+        float      value;
+    };
+
+    struct Scenario {
+        const char*        name;
+        int                blockSize;   // the maximum block size the host provides
+        bool               convolution; // whether to load the impulse response and use the convolution engine
+        std::vector<Event> script;      // ordered by position
+    };
+
+    // the scenarios rendered by the tests, each exercising a different part of the effect chain
+
+    std::vector<Scenario> getScenarios();
+
+    // the stimulus : a stereo sine sweep with noise bursts and impulses, the side chain
+    // stimulus (single channel) provides alternating loud and quiet pulses
+
+    AudioBuffer* createStimulus();
+    AudioBuffer* createSideChainStimulus();
+
+    // the impulse response for the convolution scenarios : stereo noise in an exponential decay of 500 ms
+
+    AudioBuffer* createImpulseResponse();
+
+    // creates a PluginProcess for the stimuli (with the quality governor disabled), when an impulse response
+    // path is given, it is loaded and the convolution engine is selected (as Darvaza::loadImpulseResponse() does)
+
+    PluginProcess* createProcess( int maxBlockSize, const char* impulseResponsePath = nullptr );
+
+    struct RenderOptions {
+        int  blockSize       = 512;
+        bool inPlace         = false; // process with the input and output buffers aliased
+        bool doublePrecision = false; // process 64-bit samples
+    };
+
+    // renders the input through given process into output (which must be of equal dimensions) while
+    // applying the script. The processing and the application of the events takes place within a realtime
+    // scope (see realtimecheck.h) so the test can verify the real-time safety of both
+
+    void render( PluginProcess* process, AudioBuffer* input, AudioBuffer* sideChain, AudioBuffer* output,
+                 const std::vector<Event>& script, const RenderOptions& options );
+
+    // the state of the host the events are applied to, as kept by Darvaza
+
+    struct HostState {
+        bool   playing   = false;
+        double tempo     = 120.0;
+        float  oddSpeed  = .5f;
+        float  evenSpeed = .5f;
+        bool   linkGates = false;
+    };
+
+    // applies a single event onto given process
+
+    void apply( PluginProcess* process, const Event& event, HostState& state );
+
+    struct Residual {
+        bool  bitExact       = true;
+        float residualDb     = -200.f; // RMS of the residual relative to the RMS of the reference
+        float peakResidualDb = -200.f; // peak of the residual in dBFS
+    };
+
+    // the residual of given output against given reference (which must be of equal dimensions)
+
+    Residual compare( AudioBuffer* reference, AudioBuffer* output );
+}
+}
+
+#endif
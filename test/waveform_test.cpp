@@ -0,0 +1,133 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2024 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "../src/wavegenerator.h"
+#include "../src/waveforms.h"
+#include <cmath>
+#include <cstdio>
+
+using namespace Igorski;
+
+/**
+ * Verifies the gate wavetables keep their shape at every sample rate, as the amount of partials
+ * a table is summed from depends on the sample rate (see WaveformMath::getPartials()). For the
+ * cached rates as well as for rates rendered at runtime, each waveform must differ from all other
+ * waveforms, and tables rendered at runtime must match the cached tables with the same partials.
+ *
+ * usage : waveform_test
+ */
+
+// the minimum difference (peak, on the -1 to +1 scale) between the tables of two waveforms. Note the
+// triangle follows the slope of the summed partials and thus remains relatively close to the sine
+// (at a single partial, their difference is below .01)
+
+static const float MIN_SHAPE_DIFFERENCE = .05f;
+
+// the maximum difference between a table rendered at runtime and its cached equivalent
+
+static const float MAX_RENDER_DIFFERENCE = 1e-4f;
+
+static const char* WAVEFORM_NAMES[ WaveGenerator::AMOUNT_OF_WAVEFORMS ] = { "sine", "triangle", "saw", "square" };
+
+static float getPeakDifference( const float* a, const float* b, int length )
+{
+    float peak = 0.f;
+    for ( int i = 0; i < length; ++i ) {
+        peak = std::max( peak, fabsf( a[ i ] - b[ i ] ));
+    }
+    return peak;
+}
+
+static bool verifyShapes( float sampleRate )
+{
+    WaveTable* tables[ WaveGenerator::AMOUNT_OF_WAVEFORMS ];
+    for ( int w = 0; w < WaveGenerator::AMOUNT_OF_WAVEFORMS; ++w ) {
+        tables[ w ] = WaveGenerator::generate(( WaveGenerator::WaveForms ) w, sampleRate, VST::TABLE_SIZE );
+    }
+    bool passed = true;
+
+    for ( int a = 0; a < WaveGenerator::AMOUNT_OF_WAVEFORMS; ++a ) {
+        for ( int b = a + 1; b < WaveGenerator::AMOUNT_OF_WAVEFORMS; ++b ) {
+            float difference = getPeakDifference( tables[ a ]->getBuffer(), tables[ b ]->getBuffer(), VST::TABLE_SIZE );
+
+            if ( difference < MIN_SHAPE_DIFFERENCE ) {
+                printf( "FAILED   %.0f Hz : %s and %s are alike (peak difference %f)\n",
+                    sampleRate, WAVEFORM_NAMES[ a ], WAVEFORM_NAMES[ b ], difference
+                );
+                passed = false;
+            }
+        }
+    }
+    for ( int w = 0; w < WaveGenerator::AMOUNT_OF_WAVEFORMS; ++w ) {
+        delete tables[ w ];
+    }
+    if ( passed ) {
+        printf( "ok       %.0f Hz : %d partials, all waveforms differ\n",
+            sampleRate, VST::WaveformMath::getPartials( sampleRate, VST::TABLE_SIZE )
+        );
+    }
+    return passed;
+}
+
+// renders the tables for a rate just below a cached rate (so they are rendered at
+// runtime from the same amount of partials) and compares them with the cached tables
+
+static bool verifyRender( int cachedIndex )
+{
+    float cachedRate = VST::CACHED_SAMPLE_RATES[ cachedIndex ];
+    float sampleRate = cachedRate - 1.f;
+
+    if ( VST::WaveformMath::getPartials( sampleRate, VST::TABLE_SIZE ) != VST::WaveformMath::getPartials( cachedRate, VST::TABLE_SIZE )) {
+        return true; // not comparable
+    }
+    bool passed = true;
+
+    for ( int w = 0; w < WaveGenerator::AMOUNT_OF_WAVEFORMS; ++w ) {
+        WaveTable* table = WaveGenerator::generate(( WaveGenerator::WaveForms ) w, sampleRate, VST::TABLE_SIZE );
+        float difference = getPeakDifference( table->getBuffer(), VST::CACHED_WAVEFORMS[ cachedIndex ].tables[ w ], VST::TABLE_SIZE );
+        delete table;
+
+        if ( difference > MAX_RENDER_DIFFERENCE ) {
+            printf( "FAILED   %.0f Hz : the rendered %s differs from the cached table (peak difference %f)\n",
+                sampleRate, WAVEFORM_NAMES[ w ], difference
+            );
+            passed = false;
+        }
+    }
+    return passed;
+}
+
+int main()
+{
+    const float runtimeRates[] = { 8000.f, 22050.f, 32000.f, 352800.f, 384000.f };
+
+    bool passed = true;
+
+    for ( int i = 0; i < VST::CACHED_SAMPLE_RATES_AMOUNT; ++i ) {
+        passed &= verifyShapes( VST::CACHED_SAMPLE_RATES[ i ] );
+        passed &= verifyRender( i );
+    }
+    for ( float sampleRate : runtimeRates ) {
+        passed &= verifyShapes( sampleRate );
+    }
+    return passed ? 0 : 1;
+}